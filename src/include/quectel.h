@@ -64,6 +64,9 @@ typedef struct {
 
   struct {
     uint8_t status;
+    #if QTEL_EN_FEATURE_SPOOL
+    void    *spool;             // QTEL_Spool_t replayed in background
+    #endif
   } file;
 
   #if QTEL_EN_FEATURE_NET
@@ -84,17 +87,79 @@ typedef struct {
     void (*onClosed)(void);
 
     #if QTEL_EN_FEATURE_SOCKET
-    void *sockets[QTEL_NUM_OF_SOCKET];
+    void      *sockets[QTEL_NUM_OF_SOCKET];
+    uint16_t  sockLinks;        // bit of link number which is held by socket
+    uint16_t  sockEvents;       // bit of link number which has pending events
+    uint16_t  sockReconnects;   // bit of link number which is waiting to reconnect
+    uint16_t  sockCloseReqs;    // bit of link number, ex: rejected incoming connection, aborted send
+    QTEL_Sock_Stats_t sockStats;
+    #endif
+
+    #if QTEL_EN_FEATURE_SSL
+    const void *sslContexts[QTEL_SSL_NUM_OF_CONTEXT];
+    #endif
+
+    #if QTEL_EN_FEATURE_DNS
+    uint16_t  sockResolving;    // bit of link number which is waiting for DNS
+    struct {
+      uint8_t   resolving;      // index+1 of cache being resolved, 0: none
+      uint8_t   ipLeft;         // waiting for IP line of current response
+      struct {
+        uint8_t   status;
+        uint8_t   isUsed;       // looked up since last resolving
+        uint16_t  error;
+        char      host[QTEL_DNS_HOST_SIZE];
+        char      ip[40];
+        uint32_t  ttl;          // ms
+        uint32_t  requestTick;
+        uint32_t  resolveTime;  // ms, duration of last resolving
+        uint32_t  resolvedTick;
+        uint32_t  lastUsedTick;
+      } cache[QTEL_DNS_CACHE_SIZE];
+    } dns;
+    #endif
+
+    #if QTEL_EN_FEATURE_PING
+    struct {
+      uint8_t     status;
+      uint8_t     events;
+      const char  *host;
+      uint32_t    interval;     // ms, 0: no scheduled probe
+      uint8_t     count;        // echo of each scheduled probe
+      uint8_t     echoLeft;     // echo waited on current probe
+      uint32_t    tick;         // start of last probe
+      uint32_t    timeout;      // ms, of current probe
+      uint8_t     sampleIdx;    // next written sample
+      uint8_t     sampleNum;
+      uint16_t    samples[QTEL_PING_NUM_OF_SAMPLES]; // RTT ms, QTEL_PING_LOST: lost
+      void (*onProbed)(void);
+    } ping;
     #endif
 
   } net;
 
-  #if QTEL_EN_FEATURE_NTP
+  #if QTEL_EN_FEATURE_HTTP
   struct {
     uint8_t     status;
     uint8_t     events;
     uint8_t     counterIdTmpFile;
+    uint8_t     readMode;       // QTEL_HTTP_READ_FILE or QTEL_HTTP_READ_STREAM
     const char  *lastUrl;
+    void        *downloadTmpPtr;
+    void        *cacheTmpPtr;
+    void        *reqTmpPtr;
+    void        *inflater;      // QTEL_Inflate_t for compressed content
+    uint32_t    customHeaderHash;
+    uint8_t     isReqHeader;    // requestheader mode is set in the modem
+
+    // state kept in the modem between requests of a session
+    struct {
+      uint8_t   isActive;
+      uint8_t   isConfigured;
+      int8_t    contentType;    // -1: not set
+      uint16_t  urlLen;         // 0: no URL
+      uint32_t  urlHash;
+    } session;
 
     struct {
       uint16_t error;
@@ -102,8 +167,39 @@ typedef struct {
       uint32_t contentLen;
       void *cb;
     } response;
+
+    // response header, parsed as it comes in any size of pieces
+    struct {
+      uint8_t   isClosed;
+      uint8_t   isChunked;      // Transfer-Encoding: chunked
+      uint8_t   encoding;       // QTEL_HTTP_ENCODING_x of Content-Encoding
+      uint32_t  contentLen;     // Content-Length, 0xFFFFFFFF: not given
+      char      contentType[QTEL_HTTP_CONTENT_TYPE_SIZE];
+      char      etag[QTEL_HTTP_ETAG_SIZE];
+
+      uint16_t  lineLen;        // QTEL_HTTP_HEADER_LINE_SIZE: line is too long
+      char      line[QTEL_HTTP_HEADER_LINE_SIZE];
+
+      // content decoder
+      uint32_t  contentRead;
+      uint8_t   chunkState;
+      uint32_t  chunkLeft;
+      uint8_t   isInflating;
+      uint8_t   isDecodeError;
+    } header;
+
+    // submitted QTEL_HTTP_Async_t, the head is in progress
+    struct {
+      void      *items[QTEL_HTTP_QUEUE_SIZE];
+      uint8_t   head;
+      uint8_t   count;
+    } queue;
+
+    #if QTEL_EN_FEATURE_TELEMETRY
+    void        *telemetry;     // QTEL_Telemetry_t uploaded in background
+    #endif
   } HTTP;
-  #endif /* QTEL_EN_FEATURE_NTP */
+  #endif /* QTEL_EN_FEATURE_HTTP */
 
   #if QTEL_EN_FEATURE_NTP
   struct {
@@ -133,8 +229,20 @@ typedef struct {
     Buffer_t  buffer;
     void      *xtraFileTmpPtr;
     uint8_t   readBuffer[QTEL_GPS_TMP_BUF_SIZE];
+
+    // NMEA port, sentences are streamed from it when it's set,
+    // otherwise they are polled by AT+QGPSGNMEA
+    struct {
+      void      *device;
+      uint8_t   (*isAvailable)(void *serialDev);  // optional
+      uint16_t  (*read)(void *serialDev, uint8_t *dstBuf, uint16_t bufSz, uint32_t timeout);
+    } nmeaSerial;
     lwgps_t   lwgps;
     uint32_t  nmeaTick;
+
+    // last fix in two slots, fixSeq is odd while the unpublished slot is written
+    QTEL_GPS_Fix_t    fix[2];
+    volatile uint32_t fixSeq;
   } gps;
   #endif
 
@@ -0,0 +1,65 @@
+/*
+ * cache.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_CACHE_H
+#define QTEL_QUECTEL_EC25_CACHE_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_HTTP
+
+#include "../quectel.h"
+#include "http.h"
+#include "file.h"
+
+#define QTEL_CACHE_META_MAGIC 0x514C4331  // "QLC1"
+
+#ifndef QTEL_CACHE_FILENAME_SIZE
+#define QTEL_CACHE_FILENAME_SIZE 64
+#endif
+
+#ifndef QTEL_CACHE_ETAG_SIZE
+#define QTEL_CACHE_ETAG_SIZE 64
+#endif
+
+// "Sun, 06 Nov 1994 08:49:37 GMT"
+#define QTEL_CACHE_DATE_SIZE 32
+
+typedef struct {
+  // configuration
+  const char                    *url;
+  const char                    *filename;  // body in UFS, validators are kept in "<filename>.etag"
+  uint32_t                      timeout;    // ms
+  uint8_t                       *buffer;
+  uint16_t                      bufferSize;
+  QTEL_HTTP_ContentReader_Func  onContent;  // gets the body from server or from cache
+
+  // result
+  uint8_t       isFromCache;                // 1: not modified, body is read from the file
+
+  // validators of the cached body, saved after the body is complete
+  struct {
+    uint32_t    magic;
+    uint32_t    urlHash;
+    uint32_t    length;
+    char        etag[QTEL_CACHE_ETAG_SIZE];
+    char        lastModified[QTEL_CACHE_DATE_SIZE];
+  } meta;
+
+  // validators of the current response
+  char          etag[QTEL_CACHE_ETAG_SIZE];
+  char          lastModified[QTEL_CACHE_DATE_SIZE];
+  uint32_t      received;
+  uint8_t       isError;
+  uint8_t       isFileOpen;
+  QTEL_File_t   file;
+} QTEL_HTTP_Cache_t;
+
+QTEL_Status_t QTEL_HTTP_CachedGet(QTEL_HandlerTypeDef*, QTEL_HTTP_Cache_t*);
+QTEL_Status_t QTEL_HTTP_ClearCache(QTEL_HandlerTypeDef*, const char *filename);
+
+#endif /* QTEL_EN_FEATURE_HTTP */
+#endif /* QTEL_QUECTEL_EC25_CACHE_H */
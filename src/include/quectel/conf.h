@@ -17,11 +17,71 @@
 #define QTEL_EN_FEATURE_SOCKET 1
 
 #ifndef QTEL_NUM_OF_SOCKET
-#define QTEL_NUM_OF_SOCKET  4
+#define QTEL_NUM_OF_SOCKET  12
 #endif
 
 #endif /* QTEL_EN_FEATURE_SOCKET */
 
+#if QTEL_EN_FEATURE_SOCKET
+#ifndef QTEL_SOCK_SEND_CHUNK_SIZE
+#define QTEL_SOCK_SEND_CHUNK_SIZE  1460
+#endif
+
+#ifndef QTEL_SOCK_RECV_SIZE
+#define QTEL_SOCK_RECV_SIZE  512            // max length of each AT+QIRD, up to 1500
+#endif
+
+#ifndef QTEL_EN_FEATURE_SSL
+#define QTEL_EN_FEATURE_SSL 1
+#endif
+
+#if QTEL_EN_FEATURE_SSL
+#ifndef QTEL_SSL_NUM_OF_CONTEXT
+#define QTEL_SSL_NUM_OF_CONTEXT  2
+#endif
+
+#ifndef QTEL_SSL_RECV_SIZE
+#define QTEL_SSL_RECV_SIZE  512
+#endif
+#endif /* QTEL_EN_FEATURE_SSL */
+
+#ifndef QTEL_EN_FEATURE_DNS
+#define QTEL_EN_FEATURE_DNS 1
+#endif
+
+#if QTEL_EN_FEATURE_DNS
+#ifndef QTEL_DNS_CACHE_SIZE
+#define QTEL_DNS_CACHE_SIZE  4
+#endif
+
+#ifndef QTEL_DNS_HOST_SIZE
+#define QTEL_DNS_HOST_SIZE  64
+#endif
+
+#ifndef QTEL_DNS_TIMEOUT
+#define QTEL_DNS_TIMEOUT  60000
+#endif
+#endif /* QTEL_EN_FEATURE_DNS */
+
+#ifndef QTEL_EN_FEATURE_SOCKAPI
+#define QTEL_EN_FEATURE_SOCKAPI 0
+#endif
+
+#if QTEL_EN_FEATURE_SOCKAPI
+#ifndef QTEL_SOCKAPI_NUM_OF_FD
+#define QTEL_SOCKAPI_NUM_OF_FD  4
+#endif
+
+#ifndef QTEL_SOCKAPI_RECV_SIZE
+#define QTEL_SOCKAPI_RECV_SIZE  1024
+#endif
+
+#ifndef QTEL_SOCKAPI_CONNECT_TO
+#define QTEL_SOCKAPI_CONNECT_TO 150000  // ms, AT+QIOPEN worst case
+#endif
+#endif /* QTEL_EN_FEATURE_SOCKAPI */
+#endif /* QTEL_EN_FEATURE_SOCKET */
+
 #ifndef QTEL_EN_FEATURE_NTP
 #define QTEL_EN_FEATURE_NTP 1
 #endif
@@ -30,8 +90,95 @@
 #define QTEL_EN_FEATURE_HTTP 1
 #endif
 
+#if QTEL_EN_FEATURE_HTTP
+#ifndef QTEL_HTTP_QUEUE_SIZE
+#define QTEL_HTTP_QUEUE_SIZE  4
+#endif
+
+#ifndef QTEL_HTTP_HEADER_LINE_SIZE
+#define QTEL_HTTP_HEADER_LINE_SIZE  128
+#endif
+
+#ifndef QTEL_HTTP_CONTENT_TYPE_SIZE
+#define QTEL_HTTP_CONTENT_TYPE_SIZE  48
+#endif
+
+#ifndef QTEL_HTTP_ETAG_SIZE
+#define QTEL_HTTP_ETAG_SIZE  64
+#endif
+
+// s, base of AT+QHTTPPOST <input_time>, an aborted body waits for it to expire
+#ifndef QTEL_HTTP_POST_INPUT_TIME
+#define QTEL_HTTP_POST_INPUT_TIME  5
+#endif
+
+// bytes/s, lowest expected body throughput, adds to <input_time> by body length
+#ifndef QTEL_HTTP_POST_INPUT_RATE
+#define QTEL_HTTP_POST_INPUT_RATE  4096
+#endif
+
+#ifndef QTEL_EN_FEATURE_INFLATE
+#define QTEL_EN_FEATURE_INFLATE 0
+#endif
+
+#if QTEL_EN_FEATURE_INFLATE
+// power of 2, up to 32768
+#ifndef QTEL_INFLATE_WINDOW_SIZE
+#define QTEL_INFLATE_WINDOW_SIZE  32768
+#endif
+#endif /* QTEL_EN_FEATURE_INFLATE */
+
+#ifndef QTEL_EN_FEATURE_TELEMETRY
+#define QTEL_EN_FEATURE_TELEMETRY 1
+#endif
+
+#if QTEL_EN_FEATURE_TELEMETRY
+#ifndef QTEL_TELEMETRY_URL_SIZE
+#define QTEL_TELEMETRY_URL_SIZE  128      // URL with batch query
+#endif
+#endif /* QTEL_EN_FEATURE_TELEMETRY */
+#endif /* QTEL_EN_FEATURE_HTTP */
+
+#ifndef QTEL_EN_FEATURE_DEFLATE
+#define QTEL_EN_FEATURE_DEFLATE 0
+#endif
+
+#if QTEL_EN_FEATURE_DEFLATE
+// power of 2, 1024 up to 32768, larger window finds farther match
+#ifndef QTEL_DEFLATE_WINDOW_SIZE
+#define QTEL_DEFLATE_WINDOW_SIZE  4096
+#endif
+
+// power of 2
+#ifndef QTEL_DEFLATE_HASH_SIZE
+#define QTEL_DEFLATE_HASH_SIZE    1024
+#endif
+#endif /* QTEL_EN_FEATURE_DEFLATE */
+
 #define QTEL_EN_FEATURE_NET QTEL_EN_FEATURE_NTP|QTEL_EN_FEATURE_SOCKET|QTEL_EN_FEATURE_HTTP
 
+#ifndef QTEL_EN_FEATURE_PING
+#define QTEL_EN_FEATURE_PING 1
+#endif
+
+#if QTEL_EN_FEATURE_PING
+#ifndef QTEL_PING_NUM_OF_SAMPLES
+#define QTEL_PING_NUM_OF_SAMPLES  20
+#endif
+
+#ifndef QTEL_PING_TIMEOUT
+#define QTEL_PING_TIMEOUT  4              // s, each echo
+#endif
+
+#ifndef QTEL_PING_RTT_GOOD
+#define QTEL_PING_RTT_GOOD  150           // ms, full latency score
+#endif
+
+#ifndef QTEL_PING_RTT_BAD
+#define QTEL_PING_RTT_BAD   2000          // ms, zero latency score
+#endif
+#endif /* QTEL_EN_FEATURE_PING */
+
 #ifndef QTEL_EN_FEATURE_GPS
 #define QTEL_EN_FEATURE_GPS 1
 #endif
@@ -66,10 +213,37 @@
 #define LWGPS_IGNORE_USER_OPTS
 #endif
 
+#ifndef QTEL_FILE_UPLOAD_TIMEOUT
+#define QTEL_FILE_UPLOAD_TIMEOUT  60      // s, modem waits for data
+#endif
+
+#ifndef QTEL_FILE_BLOCK_SIZE
+#define QTEL_FILE_BLOCK_SIZE  512         // cache of buffered file made by library
+#endif
+
+#ifndef QTEL_EN_FEATURE_SPOOL
+#define QTEL_EN_FEATURE_SPOOL 1
+#endif
+
+#if QTEL_EN_FEATURE_SPOOL
+#ifndef QTEL_SPOOL_NAME_SIZE
+#define QTEL_SPOOL_NAME_SIZE  32
+#endif
+#endif /* QTEL_EN_FEATURE_SPOOL */
+
 #if QTEL_EN_FEATURE_GPS
 #ifndef QTEL_GPS_TMP_BUF_SIZE
 #define QTEL_GPS_TMP_BUF_SIZE  64
 #endif
+
+// port of gps.nmeaSerial, "usbnmea" or "uartnmea"
+#ifndef QTEL_GPS_NMEA_PORT
+#define QTEL_GPS_NMEA_PORT  "usbnmea"
+#endif
+
+#ifndef QTEL_GPS_FIX_FREQ
+#define QTEL_GPS_FIX_FREQ  1              // Hz
+#endif
 #endif /* QTEL_EN_FEATURE_GPS */
 
 #endif /* QTEL_QUECTEL_EC25_CONF_H_ */
@@ -0,0 +1,49 @@
+/*
+ * deflate.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_DEFLATE_H
+#define QTEL_QUECTEL_EC25_DEFLATE_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_DEFLATE
+
+#include "types.h"
+
+#define QTEL_DEFLATE_FORMAT_RAW   0
+#define QTEL_DEFLATE_FORMAT_GZIP  2
+
+typedef void (*QTEL_Deflate_Output_Func)(void *ctx, const uint8_t *data, uint16_t length);
+
+/*
+ * streaming encoder with fixed Huffman codes, match is looked up
+ * by the last position of each 3 bytes hash. the window keeps
+ * history and the bytes waiting for the longest match
+ */
+typedef struct {
+  QTEL_Deflate_Output_Func  onOutput;
+  void                      *ctx;
+
+  uint8_t   format;
+  uint32_t  bitBuf;
+  uint8_t   bitCnt;
+  uint32_t  pos;                            // input which is encoded
+  uint32_t  inEnd;                          // input which is written
+  uint32_t  crc;
+
+  uint16_t  outLen;
+  uint8_t   out[32];
+  uint16_t  head[QTEL_DEFLATE_HASH_SIZE];   // low 16 bits of the position
+  uint8_t   window[QTEL_DEFLATE_WINDOW_SIZE];
+} QTEL_Deflate_t;
+
+void      QTEL_Deflate_Begin(QTEL_Deflate_t*, uint8_t format, QTEL_Deflate_Output_Func, void *ctx);
+void      QTEL_Deflate_Write(QTEL_Deflate_t*, const uint8_t *data, uint16_t length);
+void      QTEL_Deflate_Finish(QTEL_Deflate_t*);
+uint32_t  QTEL_Deflate_GetBound(QTEL_Deflate_t*, uint32_t length);
+
+#endif /* QTEL_EN_FEATURE_DEFLATE */
+#endif /* QTEL_QUECTEL_EC25_DEFLATE_H */
@@ -0,0 +1,36 @@
+/*
+ * digest.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_DIGEST_H
+#define QTEL_QUECTEL_EC25_DIGEST_H
+
+#include <stdint.h>
+
+#define QTEL_DIGEST_NONE    0
+#define QTEL_DIGEST_CRC32   1
+#define QTEL_DIGEST_SHA256  2
+
+#define QTEL_SHA256_SIZE    32
+
+typedef struct {
+  uint32_t  state[8];
+  uint32_t  lengthLow;      // total bytes
+  uint32_t  lengthHigh;
+  uint8_t   block[64];
+  uint8_t   blockLen;
+} QTEL_SHA256_t;
+
+// streaming CRC32 (IEEE 802.3), start with crc 0
+uint32_t  QTEL_CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length);
+// streaming Adler-32 (zlib), start with adler 1
+uint32_t  QTEL_Adler32_Update(uint32_t adler, const uint8_t *data, uint32_t length);
+
+void      QTEL_SHA256_Init(QTEL_SHA256_t*);
+void      QTEL_SHA256_Update(QTEL_SHA256_t*, const uint8_t *data, uint32_t length);
+void      QTEL_SHA256_Final(QTEL_SHA256_t*, uint8_t digest[QTEL_SHA256_SIZE]);
+
+#endif /* QTEL_QUECTEL_EC25_DIGEST_H */
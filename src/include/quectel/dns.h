@@ -0,0 +1,36 @@
+/*
+ * dns.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_DNS_H
+#define QTEL_QUECTEL_EC25_DNS_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_DNS
+
+#include "../quectel.h"
+
+#define QTEL_DNS_STATUS_EMPTY      0
+#define QTEL_DNS_STATUS_QUEUED     1
+#define QTEL_DNS_STATUS_RESOLVING  2
+#define QTEL_DNS_STATUS_RESOLVED   3
+#define QTEL_DNS_STATUS_ERROR      4
+
+#define QTEL_DNS_IP_SIZE 40
+
+#define QTEL_DNS_ERR_TIMEOUT 0xFFFF
+
+uint8_t QTEL_DNS_CheckAsyncResponse(QTEL_HandlerTypeDef*);
+void    QTEL_DNS_HandleEvents(QTEL_HandlerTypeDef*);
+
+QTEL_Status_t QTEL_DNS_Resolve(QTEL_HandlerTypeDef*, const char *host);
+QTEL_Status_t QTEL_DNS_Lookup(QTEL_HandlerTypeDef*, const char *host, char *ip);
+uint32_t      QTEL_DNS_GetResolveTime(QTEL_HandlerTypeDef*, const char *host);
+uint16_t      QTEL_DNS_GetError(QTEL_HandlerTypeDef*, const char *host);
+void          QTEL_DNS_Flush(QTEL_HandlerTypeDef*);
+
+#endif /* QTEL_EN_FEATURE_DNS */
+#endif /* QTEL_QUECTEL_EC25_DNS_H */
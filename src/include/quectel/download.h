@@ -0,0 +1,63 @@
+/*
+ * download.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_DOWNLOAD_H
+#define QTEL_QUECTEL_EC25_DOWNLOAD_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_HTTP
+
+#include "../quectel.h"
+#include "file.h"
+#include "digest.h"
+
+#define QTEL_DOWNLOAD_STATE_MAGIC 0x514C4431  // "QLD1"
+
+#ifndef QTEL_DOWNLOAD_FILENAME_SIZE
+#define QTEL_DOWNLOAD_FILENAME_SIZE 64
+#endif
+
+typedef struct {
+  // configuration
+  const char    *url;
+  const char    *filename;                  // destination in UFS, progress is kept in "<filename>.dl"
+  uint32_t      chunkSize;                  // byte of each range request, must fit in RAM file
+  uint32_t      totalSize;                  // 0: until the server sends shorter chunk
+  uint8_t       digestType;                 // QTEL_DIGEST_x
+  uint32_t      expectedCRC;
+  const uint8_t *expectedSHA256;
+  uint8_t       retryMax;                   // for each chunk
+  uint32_t      timeout;                    // ms, for each chunk
+  uint8_t       *buffer;
+  uint16_t      bufferSize;
+  void (*onProgress)(uint32_t downloaded, uint32_t totalSize);
+
+  // progress, saved after each chunk
+  struct {
+    uint32_t      magic;
+    uint32_t      urlHash;
+    uint32_t      offset;
+    uint32_t      crc;
+    QTEL_SHA256_t sha256;
+  } state;
+
+  // current chunk, merged into state when it's complete
+  struct {
+    uint32_t      received;
+    uint32_t      crc;
+    QTEL_SHA256_t sha256;
+    uint8_t       isError;
+  } chunk;
+
+  QTEL_File_t   file;
+} QTEL_HTTP_Download_t;
+
+QTEL_Status_t QTEL_HTTP_Download(QTEL_HandlerTypeDef*, QTEL_HTTP_Download_t*);
+QTEL_Status_t QTEL_HTTP_CancelDownload(QTEL_HandlerTypeDef*, const char *filename);
+
+#endif /* QTEL_EN_FEATURE_HTTP */
+#endif /* QTEL_QUECTEL_EC25_DOWNLOAD_H */
@@ -17,6 +17,14 @@ typedef enum {
   QTEL_File_Storage_MAX,
 } QTEL_File_Storage_t;
 
+/*
+ * gives data of upload at offset, length is set to the available length
+ * (not more than asked), the data must be kept until the next call
+ */
+typedef const uint8_t* (*QTEL_File_Source_Func)(void *ctx, uint32_t offset, uint16_t *length);
+
+typedef void (*QTEL_File_Sink_Func)(void *ctx, const uint8_t *data, uint16_t length);
+
 typedef struct{
   QTEL_HandlerTypeDef* hqtel;
   uint32_t fileno;
@@ -24,14 +32,41 @@ typedef struct{
   uint32_t pos;
 } QTEL_File_t;
 
+/*
+ * file with block cache, holds either read-ahead data or
+ * unwritten data, the modem position is moved only when needed
+ */
+typedef struct {
+  QTEL_File_t file;
+  uint8_t     *cache;
+  uint16_t    cacheSize;
+  uint16_t    cacheLen;
+  uint32_t    cachePos;     // file offset of cache[0]
+  uint8_t     isDirty;
+  uint32_t    pos;
+} QTEL_BFile_t;
+
 
 QTEL_Status_t QTEL_File_Upload(QTEL_HandlerTypeDef*, QTEL_File_Storage_t, const char *filename,
                                uint8_t *data, uint16_t dataLen);
+QTEL_Status_t QTEL_File_UploadStream(QTEL_HandlerTypeDef*, QTEL_File_Storage_t, const char *filename,
+                                     uint32_t fileSize, QTEL_File_Source_Func, void *ctx);
+QTEL_Status_t QTEL_File_Download(QTEL_HandlerTypeDef*, QTEL_File_Storage_t, const char *filename,
+                                 uint8_t *buffer, uint16_t bufferSize, QTEL_File_Sink_Func, void *ctx);
 QTEL_Status_t QTEL_File_Open(QTEL_HandlerTypeDef*, QTEL_File_t*, QTEL_File_Storage_t, const char *filename);
 int32_t       QTEL_File_Write(QTEL_File_t*, const uint8_t *srcData, uint16_t dataLen);
 int32_t       QTEL_File_Read(QTEL_File_t*, uint8_t *dstBuf, uint16_t bufSz);
 QTEL_Status_t QTEL_File_Seek(QTEL_File_t*, uint32_t offset);
+QTEL_Status_t QTEL_File_Truncate(QTEL_File_t*);
 QTEL_Status_t QTEL_File_Close(QTEL_File_t*);
 QTEL_Status_t QTEL_File_Delete(QTEL_HandlerTypeDef*, QTEL_File_Storage_t, const char *filename);
 
+QTEL_Status_t QTEL_BFile_Open(QTEL_HandlerTypeDef*, QTEL_BFile_t*, QTEL_File_Storage_t, const char *filename,
+                              uint8_t *cache, uint16_t cacheSize);
+int32_t       QTEL_BFile_Write(QTEL_BFile_t*, const uint8_t *srcData, uint16_t dataLen);
+int32_t       QTEL_BFile_Read(QTEL_BFile_t*, uint8_t *dstBuf, uint16_t bufSz);
+QTEL_Status_t QTEL_BFile_Seek(QTEL_BFile_t*, uint32_t offset);
+QTEL_Status_t QTEL_BFile_Flush(QTEL_BFile_t*);
+QTEL_Status_t QTEL_BFile_Close(QTEL_BFile_t*);
+
 #endif /* QTEL_QUECTEL_EC25_FILE_H */
@@ -20,6 +20,10 @@
 
 #define QTEL_GPS_CFG_KEYS_NUM 16
 
+#define QTEL_GPS_FIX_NONE 0
+#define QTEL_GPS_FIX_2D   2
+#define QTEL_GPS_FIX_3D   3
+
 #define QTEL_GPS_RPT_GPGGA 0x0001
 #define QTEL_GPS_RPT_GPRMC 0x0002
 #define QTEL_GPS_RPT_GPGSV 0x0004
@@ -69,6 +73,7 @@ QTEL_Status_t QTEL_GPS_SetupOneXTra(QTEL_HandlerTypeDef*);
 QTEL_Status_t QTEL_GPS_DeleteOneXTra(QTEL_HandlerTypeDef*);
 QTEL_Status_t QTEL_GPS_getLocation(QTEL_HandlerTypeDef*);
 QTEL_Status_t QTEL_GPS_AcquireNMEA(QTEL_HandlerTypeDef*, const char* nmea_type);
+QTEL_Status_t QTEL_GPS_GetFix(QTEL_HandlerTypeDef*, QTEL_GPS_Fix_t*);
 
 #endif /* QTEL_EN_FEATURE_GPS */
 #endif /* QTEL_QUECTEL_EC25_GPS_H_ */
@@ -11,6 +11,8 @@
 
 #include "../quectel.h"
 #include "../quectel/net.h"
+#include "../quectel/file.h"
+#include "../quectel/inflate.h"
 
 
 #define QTEL_HTTP_STATUS_REQUESTING 0x01
@@ -20,6 +22,33 @@
 
 #define QTEL_HTTP_CFG_KEYS_NUM 11
 
+// state of QTEL_HTTP_Async_t
+#define QTEL_HTTP_ASYNC_QUEUED        0
+#define QTEL_HTTP_ASYNC_WAIT_RESP     1
+#define QTEL_HTTP_ASYNC_RESPONDED     2
+#define QTEL_HTTP_ASYNC_WAIT_FILE     3
+#define QTEL_HTTP_ASYNC_FILE_READY    4
+#define QTEL_HTTP_ASYNC_READ_HEADER   5
+#define QTEL_HTTP_ASYNC_READ_CONTENT  6
+#define QTEL_HTTP_ASYNC_FAILED        7
+#define QTEL_HTTP_ASYNC_DONE          8
+
+// value of Content-Encoding
+#define QTEL_HTTP_ENCODING_IDENTITY 0
+#define QTEL_HTTP_ENCODING_GZIP     1
+#define QTEL_HTTP_ENCODING_DEFLATE  2
+#define QTEL_HTTP_ENCODING_UNKNOWN  0xFF
+
+#define QTEL_HTTP_CONTENT_LEN_UNKNOWN 0xFFFFFFFF
+
+// response body is saved in RAM file then read by AT+QFREAD,
+// content reader can send another command
+#define QTEL_HTTP_READ_FILE   0
+// response body is read directly by AT+QHTTPREAD,
+// content reader is called while the data is streamed and must not send any command.
+// in both modes the content reader gets the body without chunked encoding
+#define QTEL_HTTP_READ_STREAM 1
+
 
 typedef enum {
   QTEL_HTTP_GET,
@@ -40,21 +69,99 @@ typedef enum {
   QTEL_HTTP_CFG_CustomHeader,
 } QTEL_HTTP_ConfigKey_t;
 
+// value of QTEL_HTTP_CFG_ContentType
+#define QTEL_HTTP_CONTENT_FORM_URLENCODED 0
+#define QTEL_HTTP_CONTENT_TEXT_PLAIN      1
+#define QTEL_HTTP_CONTENT_OCTET_STREAM    2
+#define QTEL_HTTP_CONTENT_MULTIPART_FORM  3
+#define QTEL_HTTP_CONTENT_JSON            4
+
 typedef void (*QTEL_HTTP_ContentReader_Func)(QTEL_HandlerTypeDef*,
                                              const uint8_t* data,
                                              uint16_t datalen,
                                              uint32_t maxLen);
 
+// called for each line of the response header, without CRLF,
+// line longer than QTEL_HTTP_HEADER_LINE_SIZE is skipped
+typedef void (*QTEL_HTTP_HeaderReader_Func)(QTEL_HandlerTypeDef*, const char *line, uint16_t lineLen);
+
+// fill dstBuf with up to bufSz bytes of request body, return written length
+typedef uint16_t (*QTEL_HTTP_BodyProducer_Func)(void *ctx, uint8_t *dstBuf, uint16_t bufSz);
+
+typedef struct {
+  QTEL_HTTP_Method_t  method;
+  const char          *url;
+  uint32_t            timeout;              // ms
+  const char          *customHeader;        // one header line, ex: "Range: bytes=0-1023"
+
+  // body of QTEL_HTTP_POST, taken from file, producer or data
+  struct {
+    uint8_t                     contentType;
+    const uint8_t               *data;
+    uint32_t                    length;     // for data and producer
+    QTEL_HTTP_BodyProducer_Func producer;
+    void                        *ctx;
+    const char                  *filename;  // file which is already in the modem, ex: "body.json", "RAM:body.bin"
+  } body;
+
+  // response
+  QTEL_HTTP_HeaderReader_Func   onHeader;
+  QTEL_HTTP_ContentReader_Func  onContent;
+  uint8_t                       *contentBuf;
+  uint16_t                      contentBufLen;
+} QTEL_HTTP_Request_t;
+
+typedef struct QTEL_HTTP_Async QTEL_HTTP_Async_t;
+typedef void (*QTEL_HTTP_Complete_Func)(QTEL_HandlerTypeDef*, QTEL_HTTP_Async_t*);
+
+/*
+ * request of the queue, must stay valid until onComplete is called.
+ * the response is always saved in RAM file and its content is passed
+ * to request.onContent by QTEL_HTTP_HandleEvents, a chunk per call
+ */
+struct QTEL_HTTP_Async {
+  QTEL_HTTP_Request_t     request;
+  QTEL_HTTP_Complete_Func onComplete;
+  void                    *ctx;
+
+  // result
+  QTEL_Status_t           status;
+  uint16_t                error;
+  uint16_t                code;
+  uint32_t                contentLen;
+
+  uint8_t                 state;
+  uint32_t                tick;
+  QTEL_File_t             file;
+  char                    filename[16];
+};
+
 uint8_t QTEL_HTTP_CheckAsyncResponse(QTEL_HandlerTypeDef*);
 void    QTEL_HTTP_HandleEvents(QTEL_HandlerTypeDef*);
+void    QTEL_HTTP_OnStarted(QTEL_HandlerTypeDef*);
 
 QTEL_Status_t QTEL_HTTP_Config(QTEL_HandlerTypeDef*, QTEL_HTTP_ConfigKey_t, void *value);
+void          QTEL_HTTP_SetReadMode(QTEL_HandlerTypeDef*, uint8_t readMode);
+#if QTEL_EN_FEATURE_INFLATE
+void          QTEL_HTTP_SetInflater(QTEL_HandlerTypeDef*, QTEL_Inflate_t*);
+#endif
 QTEL_Status_t QTEL_HTTP_Request(QTEL_HandlerTypeDef*,
                                 QTEL_HTTP_Method_t, const char* url,
                                 QTEL_HTTP_ContentReader_Func,
                                 uint8_t *contentBuf, uint16_t contentBufLen,
                                 uint32_t timeout);
+QTEL_Status_t QTEL_HTTP_Post(QTEL_HandlerTypeDef*, const char* url,
+                             const uint8_t *body, uint32_t bodyLen,
+                             QTEL_HTTP_ContentReader_Func,
+                             uint8_t *contentBuf, uint16_t contentBufLen,
+                             uint32_t timeout);
+QTEL_Status_t QTEL_HTTP_Send(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+QTEL_Status_t QTEL_HTTP_Submit(QTEL_HandlerTypeDef*, QTEL_HTTP_Async_t*);
+QTEL_HTTP_Async_t* QTEL_HTTP_GetActive(QTEL_HandlerTypeDef*);
 QTEL_Status_t QTEL_HTTP_Stop(QTEL_HandlerTypeDef*);
+const char*   QTEL_HTTP_GetHeaderValue(const char *line, uint16_t lineLen, const char *name, uint16_t *valueLen);
+QTEL_Status_t QTEL_HTTP_BeginSession(QTEL_HandlerTypeDef*, uint16_t closeWaitTime);
+void          QTEL_HTTP_EndSession(QTEL_HandlerTypeDef*);
 
 #endif /* QTEL_EN_FEATURE_HTTP */
 #endif /* QTEL_QUECTEL_EC25_HTTP_H */
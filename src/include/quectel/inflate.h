@@ -0,0 +1,65 @@
+/*
+ * inflate.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_INFLATE_H
+#define QTEL_QUECTEL_EC25_INFLATE_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_INFLATE
+
+#include "types.h"
+
+#define QTEL_INFLATE_FORMAT_RAW   0
+#define QTEL_INFLATE_FORMAT_ZLIB  1         // raw deflate is accepted too, some servers send it as "deflate"
+#define QTEL_INFLATE_FORMAT_GZIP  2
+
+typedef void (*QTEL_Inflate_Output_Func)(void *ctx, const uint8_t *data, uint16_t length);
+
+/*
+ * streaming decoder, input can be cut anywhere.
+ * the window is also the output buffer, it must be as large as
+ * the window of the compressor (32 KiB for default zlib and gzip)
+ */
+typedef struct {
+  QTEL_Inflate_Output_Func  onOutput;
+  void                      *ctx;
+
+  uint8_t   format;
+  uint8_t   state;
+  uint8_t   isFinal;
+  uint8_t   gzFlags;
+  uint32_t  bitBuf;
+  uint8_t   bitCnt;
+
+  uint16_t  counter;                        // bytes to skip, stored length or code length index
+  uint16_t  nlen;
+  uint16_t  ndist;
+  uint16_t  ncode;
+  uint16_t  length;                         // of match
+  uint16_t  distBase;
+  uint8_t   distExtra;
+  uint32_t  trailer;
+
+  uint8_t   lengths[286+30];
+  uint16_t  litCount[16];
+  uint16_t  litSymbol[288];
+  uint16_t  distCount[16];
+  uint16_t  distSymbol[30];
+
+  uint32_t  crc;                            // gzip CRC32 or zlib Adler-32 of output
+  uint32_t  total;
+  uint16_t  windowPos;
+  uint16_t  flushPos;
+  uint8_t   window[QTEL_INFLATE_WINDOW_SIZE];
+} QTEL_Inflate_t;
+
+void          QTEL_Inflate_Begin(QTEL_Inflate_t*, uint8_t format, QTEL_Inflate_Output_Func, void *ctx);
+QTEL_Status_t QTEL_Inflate_Write(QTEL_Inflate_t*, const uint8_t *data, uint16_t length);
+uint8_t       QTEL_Inflate_IsDone(QTEL_Inflate_t*);
+
+#endif /* QTEL_EN_FEATURE_INFLATE */
+#endif /* QTEL_QUECTEL_EC25_INFLATE_H */
@@ -0,0 +1,42 @@
+/*
+ * ping.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_PING_H
+#define QTEL_QUECTEL_EC25_PING_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_PING
+
+#include "../quectel.h"
+
+#define QTEL_PING_STATUS_PROBING  0x01
+
+#define QTEL_PING_EVENT_ON_PROBED 0x01
+
+#define QTEL_PING_LOST 0xFFFF
+
+// rolling RTT statistics of last samples
+typedef struct {
+  uint8_t   sampleNum;
+  uint8_t   loss;           // %
+  uint16_t  min;            // ms
+  uint16_t  avg;            // ms
+  uint16_t  max;            // ms
+  uint16_t  p95;            // ms
+} QTEL_Ping_Stats_t;
+
+uint8_t QTEL_PING_CheckAsyncResponse(QTEL_HandlerTypeDef*);
+void    QTEL_PING_HandleEvents(QTEL_HandlerTypeDef*);
+
+QTEL_Status_t QTEL_PING_Probe(QTEL_HandlerTypeDef*, const char *host, uint8_t count);
+void          QTEL_PING_Schedule(QTEL_HandlerTypeDef*, const char *host, uint32_t interval, uint8_t count);
+void          QTEL_PING_GetStats(QTEL_HandlerTypeDef*, QTEL_Ping_Stats_t*);
+void          QTEL_PING_Reset(QTEL_HandlerTypeDef*);
+uint8_t       QTEL_PING_GetLinkQuality(QTEL_HandlerTypeDef*);
+
+#endif /* QTEL_EN_FEATURE_PING */
+#endif /* QTEL_QUECTEL_EC25_PING_H */
@@ -0,0 +1,69 @@
+/*
+ * sockapi.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_SOCKAPI_H
+#define QTEL_QUECTEL_EC25_SOCKAPI_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_SOCKET && QTEL_EN_FEATURE_SOCKAPI
+
+#include "../quectel.h"
+#include "socket.h"
+
+// error codes, returned as negative value
+#define QTEL_BSD_EIO            5
+#define QTEL_BSD_EBADF          9
+#define QTEL_BSD_EAGAIN         11
+#define QTEL_BSD_ENOMEM         12
+#define QTEL_BSD_EINVAL         22
+#define QTEL_BSD_EPIPE          32
+#define QTEL_BSD_EISCONN        106
+#define QTEL_BSD_ENOTCONN       107
+#define QTEL_BSD_ETIMEDOUT      110
+#define QTEL_BSD_ECONNREFUSED   111
+#define QTEL_BSD_EALREADY       114
+#define QTEL_BSD_EINPROGRESS    115
+
+// poll events
+#define QTEL_BSD_POLLIN   0x01
+#define QTEL_BSD_POLLOUT  0x04
+#define QTEL_BSD_POLLERR  0x08
+#define QTEL_BSD_POLLHUP  0x10
+
+typedef struct {
+  int       fd;
+  uint8_t   events;                         // requested events
+  uint8_t   revents;                        // returned events
+} QTEL_BSD_PollFd_t;
+
+typedef struct {
+  QTEL_Socket_t socket;
+  uint8_t       isUsed;
+  uint8_t       isNonBlocking;
+  uint8_t       isConnected;                // has been opened, closing means hang up
+  uint8_t       isRxDropped;                // received data was lost, recv fails until reconnected
+  uint32_t      timeout;                    // ms, for blocking recv
+  uint8_t       rxBuffer[QTEL_SOCKAPI_RECV_SIZE + 1];
+} QTEL_BSD_Desc_t;
+
+
+int     QTEL_BSD_Socket(QTEL_HandlerTypeDef*, uint8_t type);
+int     QTEL_BSD_SetNonBlocking(int fd, uint8_t enable);
+int     QTEL_BSD_SetTimeout(int fd, uint32_t timeout);
+#if QTEL_EN_FEATURE_SSL
+int     QTEL_BSD_SetSSLContext(int fd, uint8_t sslCtxId);
+#endif
+int     QTEL_BSD_Connect(int fd, const char *host, uint16_t port);
+int32_t QTEL_BSD_Send(int fd, const void *data, uint32_t length);
+int32_t QTEL_BSD_Recv(int fd, void *buffer, uint16_t length);
+int     QTEL_BSD_Close(int fd);
+int     QTEL_BSD_Poll(QTEL_BSD_PollFd_t *fds, uint8_t nfds, int32_t timeout);
+
+void    QTEL_BSD_Wait(QTEL_HandlerTypeDef*);
+
+#endif /* QTEL_EN_FEATURE_SOCKET && QTEL_EN_FEATURE_SOCKAPI */
+#endif /* QTEL_QUECTEL_EC25_SOCKAPI_H */
@@ -18,6 +18,8 @@
 
 #define QTEL_SOCK_UDP    0
 #define QTEL_SOCK_TCPIP  1
+#define QTEL_SOCK_TCP_LISTENER 2
+#define QTEL_SOCK_SSL    3
 
 #define QTEL_SOCK_STATE_CLOSED   0x00
 #define QTEL_SOCK_STATE_OPENING  0x01
@@ -31,9 +33,19 @@
 #define QTEL_SOCK_EVENT_ON_RECEIVED      0x04
 #define QTEL_SOCK_EVENT_ON_CLOSED        0x08
 #define QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR 0x10
+#define QTEL_SOCK_EVENT_ON_RECV_PENDING  0x20
+#define QTEL_SOCK_EVENT_ON_RESOLVED      0x40
+#define QTEL_SOCK_EVENT_ON_RX_DROPPED    0x80
 
 #define QTEL_SOCK_IS_STATE(sock, stat)    ((sock)->state == stat)
-#define QTEL_SOCK_SET_STATE(sock, stat)   ((sock)->state = stat)
+#define QTEL_SOCK_SET_STATE(sock, stat)   {\
+  if ((sock)->state != (stat)) {\
+    if ((sock)->state == QTEL_SOCK_STATE_OPEN)\
+      (sock)->stats.connectedTime += QTEL_GetTick() - (sock)->tick.state;\
+    (sock)->tick.state = QTEL_GetTick();\
+  }\
+  (sock)->state = stat;\
+}
 
 #define QTEL_SOCK_CFG_KEYS_NUM 14
 
@@ -56,29 +68,61 @@ typedef enum {
 } QTEL_Sock_ConfigKey_t;
 
 
+// data segment for scatter sending, ex: the two halves of a ring buffer
 typedef struct {
+  const uint8_t *data;
+  uint32_t      length;
+} QTEL_Sock_Span_t;
+
+// fill dstBuf with up to bufSz bytes of the stream, return written length
+typedef uint16_t (*QTEL_Sock_Producer_Func)(void *ctx, uint8_t *dstBuf, uint16_t bufSz);
+typedef void     (*QTEL_Sock_Progress_Func)(void *ctx, uint32_t sentLen, uint32_t totalLen);
+
+
+typedef struct QTEL_Socket_t {
   QTEL_HandlerTypeDef  *hqtel;
   uint8_t             state;
   uint8_t             events;               // Events flag
   int8_t              linkNum;
-  uint8_t             type;                 // QTEL_SOCK_UDP or QTEL_SOCK_TCPIP
+  uint16_t            error;                // last opening error code of the modem
+  uint8_t             type;                 // QTEL_SOCK_UDP, QTEL_SOCK_TCPIP, QTEL_SOCK_TCP_LISTENER or QTEL_SOCK_SSL
 
   // configuration
   struct {
     uint32_t timeout;
     uint8_t  autoReconnect;
-    uint16_t reconnectingDelay;
+    uint16_t reconnectingDelay;             // ms, base delay of reconnecting
+    uint16_t reconnectingMultiplier;        // *0.01, delay multiplier of each failed attempt
+    uint32_t reconnectingDelayMax;          // ms, cap of reconnecting delay
+    uint8_t  reconnectingJitter;            // %, random deviation of reconnecting delay
+    uint8_t  sslCtxId;                      // only for QTEL_SOCK_SSL
   } config;
 
   // tick register for delay and timeout
   struct {
     uint32_t reconnDelay;
     uint32_t connecting;
+    uint32_t state;                         // last state changing
   } tick;
 
-  // server
+  // reconnecting
+  struct {
+    uint32_t delay;                         // ms, current delay before reconnecting
+    uint16_t attempt;                       // failed attempts since last connected
+    uint32_t count;                         // total of reconnecting
+  } reconnect;
+
+  QTEL_Sock_Stats_t stats;
+
+  // duration of last opening
+  struct {
+    uint32_t dns;                           // ms, 0 if address was cached
+    uint32_t connect;                       // ms, from AT+QIOPEN to opened
+  } latency;
+
+  // server, or remote client for accepted socket
   char     host[64];
-  uint16_t port;
+  uint16_t port;                            // local port for QTEL_SOCK_TCP_LISTENER
 
   // listener
   struct {
@@ -87,10 +131,32 @@ typedef struct {
     void (*onConnectError)(void);
     void (*onClosed)(void);
     void (*onReceived)(Buffer_t*);
+
+    // only with span buffer (see QTEL_SOCK_SetSpanBuffer), called once for each
+    // received data, spans stay valid until they are released by QTEL_SOCK_Consume
+    void (*onReceivedSpans)(struct QTEL_Socket_t*, const QTEL_Sock_Span_t *spans, uint8_t spanNum);
+
+    // only with span buffer, pushed data didn't fit in the full buffer and was lost
+    // (counted in stats.rxDropped), the socket is closed when it's not set
+    void (*onRxDropped)(struct QTEL_Socket_t*);
+
+    // only for QTEL_SOCK_TCP_LISTENER, called when client connected.
+    // return initiated socket (with buffer) to hold the connection or NULL to reject it
+    struct QTEL_Socket_t* (*onAccept)(struct QTEL_Socket_t *server, const char *remoteIP, uint16_t remotePort);
   } listeners;
 
   // buffer
   Buffer_t buffer;
+
+  // receiving ring of zero-copy reading, used instead of buffer when it's set
+  struct {
+    uint8_t  *buffer;
+    uint16_t size;                          // last byte of the memory is not included
+    uint16_t head;                          // next written index
+    uint16_t tail;                          // next consumed index
+    uint16_t delivered;                     // end index of data passed to the listener
+    uint8_t  isStalled;                     // data is left in the modem until consumed
+  } rx;
 } QTEL_Socket_t;
 
 uint8_t QTEL_SockCheckAsyncResponse(QTEL_HandlerTypeDef*);
@@ -99,20 +165,50 @@ void    QTEL_SockHandleEvents(QTEL_HandlerTypeDef*);
 // glabal event handler
 void    QTEL_SockOnStarted(QTEL_HandlerTypeDef*);
 void    QTEL_SockOnNetOpened(QTEL_HandlerTypeDef*);
+#if QTEL_EN_FEATURE_DNS
+void    QTEL_SockOnResolved(QTEL_HandlerTypeDef*, const char *host);
+#endif
 
 // quectel feature net and socket
 QTEL_Status_t QTEL_SockConfig(QTEL_HandlerTypeDef*, QTEL_Sock_ConfigKey_t, void *value);
 QTEL_Status_t QTEL_SockOpenTCPIP(QTEL_HandlerTypeDef*, int8_t *linkNum, const char *host, uint16_t port);
+QTEL_Status_t QTEL_SockOpenTCPListener(QTEL_HandlerTypeDef*, int8_t *linkNum, uint16_t localPort);
+#if QTEL_EN_FEATURE_SSL
+QTEL_Status_t QTEL_SockOpenSSL(QTEL_HandlerTypeDef*, int8_t *linkNum, uint8_t sslCtxId, const char *host, uint16_t port);
+#endif
 QTEL_Status_t QTEL_SockClose(QTEL_HandlerTypeDef*, uint8_t linkNum);
 void          QTEL_SockRemoveListener(QTEL_HandlerTypeDef*, uint8_t linkNum);
 uint16_t      QTEL_SockSendData(QTEL_HandlerTypeDef*, int8_t linkNum, const uint8_t *data, uint16_t length);
+QTEL_Status_t QTEL_SockGetSendState(QTEL_HandlerTypeDef*, int8_t linkNum,
+                                    uint32_t *totalLen, uint32_t *ackedLen, uint32_t *unackedLen);
+void          QTEL_SockGetStats(QTEL_HandlerTypeDef*, QTEL_Sock_Stats_t*);
+void          QTEL_SockResetStats(QTEL_HandlerTypeDef*);
+uint32_t      QTEL_SockSendSpans(QTEL_HandlerTypeDef*, int8_t linkNum,
+                                 const QTEL_Sock_Span_t *spans, uint8_t spanNum,
+                                 QTEL_Sock_Progress_Func, void *ctx);
+uint32_t      QTEL_SockSendStream(QTEL_HandlerTypeDef*, int8_t linkNum, uint32_t length,
+                                  QTEL_Sock_Producer_Func, QTEL_Sock_Progress_Func, void *ctx);
+uint32_t      QTEL_SockSendBuffer(QTEL_HandlerTypeDef*, int8_t linkNum, Buffer_t *src, uint32_t length,
+                                  QTEL_Sock_Progress_Func, void *ctx);
 
 // socket method
 QTEL_Status_t  QTEL_SOCK_Init(QTEL_Socket_t*, const char *host, uint16_t port);
+QTEL_Status_t  QTEL_SOCK_InitListener(QTEL_Socket_t*, uint16_t localPort);
+#if QTEL_EN_FEATURE_SSL
+QTEL_Status_t  QTEL_SOCK_InitSSL(QTEL_Socket_t*, uint8_t sslCtxId, const char *host, uint16_t port);
+#endif
 void          QTEL_SOCK_SetBuffer(QTEL_Socket_t*, uint8_t *buffer, uint16_t size);
+void          QTEL_SOCK_SetSpanBuffer(QTEL_Socket_t*, uint8_t *buffer, uint16_t size);
+uint8_t       QTEL_SOCK_PeekSpans(QTEL_Socket_t*, QTEL_Sock_Span_t spans[2]);
+void          QTEL_SOCK_Consume(QTEL_Socket_t*, uint16_t length);
 QTEL_Status_t  QTEL_SOCK_Open(QTEL_Socket_t*, QTEL_HandlerTypeDef*);
 void          QTEL_SOCK_Close(QTEL_Socket_t*);
 uint16_t      QTEL_SOCK_SendData(QTEL_Socket_t*, const uint8_t *data, uint16_t length);
+uint32_t      QTEL_SOCK_SendStream(QTEL_Socket_t*, uint32_t length,
+                                   QTEL_Sock_Producer_Func, QTEL_Sock_Progress_Func, void *ctx);
+uint32_t      QTEL_SOCK_GetStateDuration(QTEL_Socket_t*);
+void          QTEL_SOCK_GetStats(QTEL_Socket_t*, QTEL_Sock_Stats_t*);
+void          QTEL_SOCK_ResetStats(QTEL_Socket_t*);
 
 #endif /* QTEL_EN_FEATURE_SOCKET */
 #endif /* QTEL_QUECTEL_EC25_SIMSOCK_H_ */
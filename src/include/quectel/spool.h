@@ -0,0 +1,71 @@
+/*
+ * spool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_SPOOL_H
+#define QTEL_QUECTEL_EC25_SPOOL_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_SPOOL
+
+#include "../quectel.h"
+#include "file.h"
+
+#define QTEL_SPOOL_POS_MAGIC    0x514C5331  // "QLS1"
+
+#define QTEL_SPOOL_DROP_OLDEST  0           // full spool evicts the oldest records
+#define QTEL_SPOOL_DROP_NEWEST  1           // full spool rejects new record
+
+// <0xA5><0><length 2><crc32 4><data><0x5A>, record is valid only with the last byte
+#define QTEL_SPOOL_RECORD_OVERHEAD 9
+
+/*
+ * gets a batch of count records, each is framed as <length 2, LE><data>,
+ * the records are removed from spool only if QTEL_OK is returned
+ */
+typedef QTEL_Status_t (*QTEL_SPOOL_Sender_Func)(void *ctx, const uint8_t *data, uint16_t length, uint16_t count);
+
+/*
+ * records are appended to one of two segment files "<name>.0" and "<name>.1",
+ * the writing moves to the other segment when it is full and the other is sent,
+ * read position is kept in two slots of "<name>.pos"
+ */
+typedef struct {
+  // configuration
+  const char              *name;
+  QTEL_File_Storage_t     storage;
+  uint32_t                maxSize;        // bytes of both segments
+  uint8_t                 policy;         // QTEL_SPOOL_DROP_x
+  uint8_t                 *buffer;        // batch of replay, record can't be larger than it
+  uint16_t                bufferSize;
+  QTEL_SPOOL_Sender_Func  onSend;
+  void                    *ctx;
+  uint32_t                replayInterval; // ms, retry of replay while network is open, 0: manual only
+
+  // state
+  QTEL_HandlerTypeDef     *hqtel;
+  QTEL_File_t             writeFile;
+  uint8_t                 readSeg;
+  uint8_t                 writeSeg;
+  uint32_t                readPos;
+  uint16_t                posSeq;         // of last saved position
+  uint32_t                segLen[2];
+  uint16_t                segCount[2];    // records not sent yet
+  uint32_t                count;
+  uint32_t                dropped;        // records evicted by QTEL_SPOOL_DROP_OLDEST or corrupted
+  uint32_t                tick;
+} QTEL_Spool_t;
+
+void          QTEL_SPOOL_HandleEvents(QTEL_HandlerTypeDef*);
+void          QTEL_SPOOL_OnStarted(QTEL_HandlerTypeDef*);
+
+QTEL_Status_t QTEL_SPOOL_Open(QTEL_HandlerTypeDef*, QTEL_Spool_t*);
+QTEL_Status_t QTEL_SPOOL_Append(QTEL_Spool_t*, const uint8_t *data, uint16_t length);
+QTEL_Status_t QTEL_SPOOL_Replay(QTEL_Spool_t*);
+QTEL_Status_t QTEL_SPOOL_Close(QTEL_Spool_t*);
+
+#endif /* QTEL_EN_FEATURE_SPOOL */
+#endif /* QTEL_QUECTEL_EC25_SPOOL_H */
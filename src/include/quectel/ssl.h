@@ -0,0 +1,69 @@
+/*
+ * ssl.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_SSL_H
+#define QTEL_QUECTEL_EC25_SSL_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_SSL
+
+#include "../quectel.h"
+
+#define QTEL_SSL_CFG_KEYS_NUM 10
+
+#define QTEL_SSL_VER_SSL30    0
+#define QTEL_SSL_VER_TLS10    1
+#define QTEL_SSL_VER_TLS11    2
+#define QTEL_SSL_VER_TLS12    3
+#define QTEL_SSL_VER_ALL      4
+
+#define QTEL_SSL_SECLEVEL_NONE        0
+#define QTEL_SSL_SECLEVEL_SERVER      1
+#define QTEL_SSL_SECLEVEL_SERVER_CLIENT 2
+
+// validity time of certificates against local time
+#define QTEL_SSL_LOCALTIME_AUTO       0   // checked once the clock was synced by NTP
+#define QTEL_SSL_LOCALTIME_IGNORE     1
+#define QTEL_SSL_LOCALTIME_CHECK      2
+
+typedef enum {
+  // key                          // <valueTypedata>
+  QTEL_SSL_CFG_SSLVersion,        // <uint8_t>  QTEL_SSL_VER_x
+  QTEL_SSL_CFG_CipherSuite,       // <uint16_t> 0xFFFF: support all
+  QTEL_SSL_CFG_CACert,            // <char*>    file name in UFS
+  QTEL_SSL_CFG_ClientCert,        // <char*>    file name in UFS
+  QTEL_SSL_CFG_ClientKey,         // <char*>    file name in UFS
+  QTEL_SSL_CFG_SecLevel,          // <uint8_t>  QTEL_SSL_SECLEVEL_x
+  QTEL_SSL_CFG_IgnoreLocalTime,   // <boolean>
+  QTEL_SSL_CFG_NegotiateTime,     // <uint16_t> second
+  QTEL_SSL_CFG_SNI,               // <boolean>
+  QTEL_SSL_CFG_SessionCache,      // <boolean>  | 1: resume session on reconnect
+} QTEL_SSL_ConfigKey_t;
+
+typedef struct {
+  uint8_t     ctxId;              // 0 - (QTEL_SSL_NUM_OF_CONTEXT-1)
+  uint8_t     sslVersion;
+  uint8_t     secLevel;
+  uint8_t     sni;
+  uint8_t     sessionCache;
+  uint8_t     localTime;          // QTEL_SSL_LOCALTIME_x
+  uint16_t    cipherSuite;
+  uint16_t    negotiateTime;
+  const char  *caCertFile;
+  const char  *clientCertFile;
+  const char  *clientKeyFile;
+} QTEL_SSL_Context_t;
+
+void          QTEL_SSL_OnNetOpened(QTEL_HandlerTypeDef*);
+void          QTEL_SSL_OnClockSynced(QTEL_HandlerTypeDef*);
+
+QTEL_Status_t QTEL_SSL_Config(QTEL_HandlerTypeDef*, uint8_t ctxId, QTEL_SSL_ConfigKey_t, void *value);
+QTEL_Status_t QTEL_SSL_SetupContext(QTEL_HandlerTypeDef*, const QTEL_SSL_Context_t*);
+QTEL_Status_t QTEL_SSL_UploadFile(QTEL_HandlerTypeDef*, const char *filename, uint8_t *data, uint16_t dataLen);
+
+#endif /* QTEL_EN_FEATURE_SSL */
+#endif /* QTEL_QUECTEL_EC25_SSL_H */
@@ -0,0 +1,79 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#ifndef QTEL_QUECTEL_EC25_TELEMETRY_H
+#define QTEL_QUECTEL_EC25_TELEMETRY_H
+
+#include "conf.h"
+#if QTEL_EN_FEATURE_HTTP && QTEL_EN_FEATURE_TELEMETRY
+
+#include "../quectel.h"
+#include "http.h"
+#include "file.h"
+#include "deflate.h"
+
+// upload of batch by other than HTTP, ex: socket, the batch is in buffer
+typedef QTEL_Status_t (*QTEL_TELEMETRY_Sender_Func)(void *ctx, uint32_t batchId,
+                                                    const uint8_t *data, uint16_t length);
+
+typedef struct {
+  uint32_t  batches;
+  uint32_t  records;
+  uint32_t  rawBytes;
+  uint32_t  sentBytes;
+  uint32_t  savedBytes;
+  uint16_t  ratio;          // %, sent bytes of raw bytes
+  uint32_t  dropped;        // records of batch given up after maxRetry
+} QTEL_Telemetry_Stats_t;
+
+/*
+ * records are collected in one batch in buffer or in UFS file,
+ * the batch is uploaded when it's full or after interval, failed upload is
+ * retried with the same batch id, so the server can ignore the duplicate
+ */
+typedef struct {
+  // configuration
+  const char                  *url;           // POST of batch, "batch=<id>" is added to its query
+  uint8_t                     contentType;    // QTEL_HTTP_CONTENT_x of joined records
+  QTEL_TELEMETRY_Sender_Func  onSend;         // used instead of url
+  void                        *ctx;
+  const char                  *filename;      // batch is collected in UFS, NULL: in buffer
+  uint8_t                     *buffer;        // batch or cache of the file
+  uint16_t                    bufferSize;
+  uint32_t                    batchSize;      // bytes to upload, 0: buffer size, required by file
+  uint32_t                    interval;       // ms, upload of unfull batch, 0: only when full
+  uint32_t                    retryInterval;  // ms
+  uint8_t                     maxRetry;       // 0: forever
+  uint32_t                    timeout;        // ms, of HTTP request
+  #if QTEL_EN_FEATURE_DEFLATE
+  QTEL_Deflate_t              *deflater;      // batch is sent with gzip encoding, NULL: not compressed
+  #endif
+  uint32_t                    batchId;        // of next batch, must be unique over restarts, ex: from RTC
+
+  // state
+  QTEL_HandlerTypeDef         *hqtel;
+  uint8_t                     isOpen;
+  uint8_t                     isSealed;       // finished, waiting for retry
+  uint8_t                     isError;
+  uint8_t                     retry;
+  uint32_t                    tick;           // batch open or last failed upload
+  uint32_t                    length;         // bytes of batch
+  uint32_t                    rawLength;
+  uint16_t                    records;
+  QTEL_BFile_t                file;
+  QTEL_Telemetry_Stats_t      stats;
+} QTEL_Telemetry_t;
+
+void          QTEL_TELEMETRY_HandleEvents(QTEL_HandlerTypeDef*);
+
+QTEL_Status_t QTEL_TELEMETRY_Init(QTEL_HandlerTypeDef*, QTEL_Telemetry_t*);
+QTEL_Status_t QTEL_TELEMETRY_Add(QTEL_Telemetry_t*, const uint8_t *data, uint16_t length);
+QTEL_Status_t QTEL_TELEMETRY_Flush(QTEL_Telemetry_t*);
+void          QTEL_TELEMETRY_GetStats(QTEL_Telemetry_t*, QTEL_Telemetry_Stats_t*);
+
+#endif /* QTEL_EN_FEATURE_HTTP && QTEL_EN_FEATURE_TELEMETRY */
+#endif /* QTEL_QUECTEL_EC25_TELEMETRY_H */
@@ -30,4 +30,34 @@ typedef struct {
   int8_t  timezone;
 } QTEL_Datetime;
 
+// socket traffic statistics, for each socket and summary of handler
+typedef struct {
+  uint32_t txBytes;
+  uint32_t rxBytes;
+  uint32_t rxDropped;       // received data discarded because of full buffer
+  uint32_t txCount;         // succeeded send command
+  uint32_t txFailed;        // failed send command
+  uint32_t txLatencyTotal;  // ms, sum of succeeded send command
+  uint32_t txLatencyMax;    // ms
+  uint32_t reconnects;
+  uint32_t connectedTime;   // ms
+} QTEL_Sock_Stats_t;
+
+// GNSS fix, parsed from AT+QGPSLOC or NMEA sentences
+typedef struct {
+  QTEL_Datetime time;       // UTC
+  double    latitude;       // degree, south is negative
+  double    longitude;      // degree, west is negative
+  float     altitude;       // m, above mean sea level
+  float     speed;          // km/h
+  float     course;         // degree from true north
+  float     hdop;
+  uint8_t   satellites;
+  uint8_t   fixType;        // QTEL_GPS_FIX_x
+
+  uint32_t  seq;            // number of the fix, increased on each new one
+  uint32_t  tick;           // when the fix was parsed
+  uint32_t  age;            // ms, filled on read
+} QTEL_GPS_Fix_t;
+
 #endif /* QTEL_QUECTEL_EC25_TYPES_H_ */
\ No newline at end of file
@@ -20,6 +20,9 @@
 #ifndef QTEL_Delay
 #define QTEL_Delay(ms) HAL_Delay(ms)
 #endif
+#ifndef QTEL_MemoryBarrier
+#define QTEL_MemoryBarrier() __sync_synchronize()
+#endif
 
 #define QTEL_IsTimeout(lastTick, timeout) ((QTEL_GetTick() - (lastTick)) > (timeout))
 
@@ -79,5 +82,6 @@ QTEL_Status_t QTEL_GetMultipleResponse(QTEL_HandlerTypeDef*,
                                        uint32_t timeout);
 uint16_t      QTEL_GetData(QTEL_HandlerTypeDef*, uint8_t *respData, uint16_t rdsize, uint32_t timeout);
 const uint8_t *QTEL_ParseStr(const uint8_t *separator, uint8_t delimiter, int idx, uint8_t *output);
+uint32_t      QTEL_Random(void);
 
 #endif /* QTEL_QUECTEL_EC25_SIMCOM_UTILS_H_ */
@@ -0,0 +1,237 @@
+/*
+ * cache.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/http.h"
+#include "../include/quectel/file.h"
+#include "../include/quectel/digest.h"
+#include "../include/quectel/cache.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdio.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_HTTP
+
+#define META_FILE_FORMAT "%s.etag"
+
+static void           loadMeta(QTEL_HandlerTypeDef*, QTEL_HTTP_Cache_t*, const char *metaFilename);
+static QTEL_Status_t  saveMeta(QTEL_HandlerTypeDef*, QTEL_HTTP_Cache_t*, const char *metaFilename);
+static QTEL_Status_t  serveCache(QTEL_HandlerTypeDef*, QTEL_HTTP_Cache_t*);
+static void           readValidator(QTEL_HandlerTypeDef*, const char *line, uint16_t lineLen);
+static void           writeBody(QTEL_HandlerTypeDef*, const uint8_t *data, uint16_t dataLen, uint32_t maxLen);
+
+
+/**
+ * GET with If-None-Match or If-Modified-Since of the cached body,
+ * on 304 the body is read from the file in UFS
+ */
+QTEL_Status_t QTEL_HTTP_CachedGet(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Cache_t *cache)
+{
+  QTEL_Status_t       status;
+  QTEL_HTTP_Request_t req;
+  char                metaFilename[QTEL_CACHE_FILENAME_SIZE];
+  char                condHeader[QTEL_CACHE_ETAG_SIZE + 16];
+  uint8_t             readMode = hqtel->HTTP.readMode;
+
+  if (cache->buffer == NULL || cache->bufferSize == 0) return QTEL_ERROR;
+  if (snprintf(metaFilename, sizeof(metaFilename), META_FILE_FORMAT, cache->filename)
+      >= (int) sizeof(metaFilename))
+  {
+    return QTEL_ERROR;
+  }
+
+  loadMeta(hqtel, cache, metaFilename);
+  cache->isFromCache = 0;
+  cache->received = 0;
+  cache->isError = 0;
+  cache->isFileOpen = 0;
+  cache->etag[0] = 0;
+  cache->lastModified[0] = 0;
+
+  condHeader[0] = 0;
+  if (cache->meta.etag[0] != 0)
+    sprintf(condHeader, "If-None-Match: %s", cache->meta.etag);
+  else if (cache->meta.lastModified[0] != 0)
+    sprintf(condHeader, "If-Modified-Since: %s", cache->meta.lastModified);
+
+  // writer writes into the file, so the response must be read from RAM file
+  hqtel->HTTP.readMode = QTEL_HTTP_READ_FILE;
+  hqtel->HTTP.cacheTmpPtr = cache;
+
+  memset(&req, 0, sizeof(QTEL_HTTP_Request_t));
+  req.method = QTEL_HTTP_GET;
+  req.url = cache->url;
+  req.timeout = cache->timeout;
+  req.customHeader = (condHeader[0] != 0)? condHeader : NULL;
+  req.onHeader = readValidator;
+  req.onContent = writeBody;
+  req.contentBuf = cache->buffer;
+  req.contentBufLen = cache->bufferSize;
+  status = QTEL_HTTP_Send(hqtel, &req);
+
+  hqtel->HTTP.cacheTmpPtr = NULL;
+  hqtel->HTTP.readMode = readMode;
+
+  if (cache->isFileOpen) QTEL_File_Close(&cache->file);
+  if (status != QTEL_OK) return status;
+
+  if (hqtel->HTTP.response.code == 304 && cache->meta.magic == QTEL_CACHE_META_MAGIC) {
+    cache->isFromCache = 1;
+    return serveCache(hqtel, cache);
+  }
+
+  if (hqtel->HTTP.response.code == 200) {
+    if (cache->isError) return QTEL_ERROR;
+
+    // response without validator can't be revalidated
+    if (cache->etag[0] == 0 && cache->lastModified[0] == 0) return QTEL_OK;
+
+    if (!cache->isFileOpen)
+      QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, cache->filename);
+    cache->meta.magic = QTEL_CACHE_META_MAGIC;
+    cache->meta.length = cache->received;
+    memcpy(cache->meta.etag, cache->etag, QTEL_CACHE_ETAG_SIZE);
+    memcpy(cache->meta.lastModified, cache->lastModified, QTEL_CACHE_DATE_SIZE);
+    return saveMeta(hqtel, cache, metaFilename);
+  }
+
+  return QTEL_OK;
+}
+
+
+QTEL_Status_t QTEL_HTTP_ClearCache(QTEL_HandlerTypeDef *hqtel, const char *filename)
+{
+  char metaFilename[QTEL_CACHE_FILENAME_SIZE];
+
+  if (snprintf(metaFilename, sizeof(metaFilename), META_FILE_FORMAT, filename)
+      >= (int) sizeof(metaFilename))
+  {
+    return QTEL_ERROR;
+  }
+  QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, filename);
+  return QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, metaFilename);
+}
+
+
+/*
+ * validators are used only if they belong to the same URL
+ * and the body in the file is complete
+ */
+static void loadMeta(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Cache_t *cache, const char *metaFilename)
+{
+  QTEL_File_t metaFile;
+  int32_t     readLen = -1;
+  uint8_t     isComplete;
+  uint32_t    urlHash = QTEL_CRC32_Update(0, (const uint8_t*) cache->url, strlen(cache->url));
+
+  if (QTEL_File_Open(hqtel, &metaFile, QTEL_File_Storage_UFS, metaFilename) == QTEL_OK) {
+    if (metaFile.length == sizeof(cache->meta))
+      readLen = QTEL_File_Read(&metaFile, (uint8_t*) &cache->meta, sizeof(cache->meta));
+    QTEL_File_Close(&metaFile);
+  }
+
+  if (readLen == (int32_t) sizeof(cache->meta)
+      && cache->meta.magic == QTEL_CACHE_META_MAGIC
+      && cache->meta.urlHash == urlHash)
+  {
+    if (cache->meta.length == 0) return;
+    if (QTEL_File_Open(hqtel, &cache->file, QTEL_File_Storage_UFS, cache->filename) == QTEL_OK) {
+      isComplete = (cache->file.length == cache->meta.length);
+      QTEL_File_Close(&cache->file);
+      if (isComplete) return;
+    }
+  }
+
+  memset(&cache->meta, 0, sizeof(cache->meta));
+  cache->meta.urlHash = urlHash;
+}
+
+
+static QTEL_Status_t saveMeta(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Cache_t *cache, const char *metaFilename)
+{
+  QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, metaFilename);
+  return QTEL_File_Upload(hqtel, QTEL_File_Storage_UFS, metaFilename,
+                          (uint8_t*) &cache->meta, sizeof(cache->meta));
+}
+
+
+static QTEL_Status_t serveCache(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Cache_t *cache)
+{
+  QTEL_Status_t status;
+  int32_t       readLen;
+
+  if (cache->meta.length == 0) return QTEL_OK;
+
+  status = QTEL_File_Open(hqtel, &cache->file, QTEL_File_Storage_UFS, cache->filename);
+  if (status != QTEL_OK) return status;
+
+  while ((readLen = QTEL_File_Read(&cache->file, cache->buffer, cache->bufferSize)) > 0) {
+    if (cache->onContent != NULL)
+      cache->onContent(hqtel, cache->buffer, (uint16_t) readLen, cache->meta.length);
+  }
+  QTEL_File_Close(&cache->file);
+
+  return (readLen < 0)? QTEL_ERROR : QTEL_OK;
+}
+
+
+static void readValidator(QTEL_HandlerTypeDef *hqtel, const char *line, uint16_t lineLen)
+{
+  QTEL_HTTP_Cache_t *cache = (QTEL_HTTP_Cache_t*) hqtel->HTTP.cacheTmpPtr;
+  const char        *value;
+  uint16_t          valueLen;
+
+  if (cache == NULL) return;
+
+  // too long value is ignored, so the response isn't revalidated by it
+  if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "etag", &valueLen)) != NULL) {
+    if (valueLen >= QTEL_CACHE_ETAG_SIZE) return;
+    memcpy(cache->etag, value, valueLen);
+    cache->etag[valueLen] = 0;
+  }
+  else if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "last-modified", &valueLen)) != NULL) {
+    if (valueLen >= QTEL_CACHE_DATE_SIZE) return;
+    memcpy(cache->lastModified, value, valueLen);
+    cache->lastModified[valueLen] = 0;
+  }
+}
+
+
+/*
+ * new body replaces the cached one, the validators are removed first
+ * so an unfinished body is never used
+ */
+static void writeBody(QTEL_HandlerTypeDef *hqtel, const uint8_t *data, uint16_t dataLen, uint32_t maxLen)
+{
+  QTEL_HTTP_Cache_t *cache = (QTEL_HTTP_Cache_t*) hqtel->HTTP.cacheTmpPtr;
+  char              metaFilename[QTEL_CACHE_FILENAME_SIZE];
+
+  if (cache == NULL) return;
+  if (cache->onContent != NULL) cache->onContent(hqtel, data, dataLen, maxLen);
+  if (hqtel->HTTP.response.code != 200 || cache->isError) return;
+
+  if (!cache->isFileOpen) {
+    snprintf(metaFilename, sizeof(metaFilename), META_FILE_FORMAT, cache->filename);
+    QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, metaFilename);
+    QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, cache->filename);
+    cache->meta.magic = 0;
+    if (QTEL_File_Open(hqtel, &cache->file, QTEL_File_Storage_UFS, cache->filename) != QTEL_OK) {
+      cache->isError = 1;
+      return;
+    }
+    cache->isFileOpen = 1;
+  }
+
+  if (QTEL_File_Write(&cache->file, data, dataLen) != (int32_t) dataLen) {
+    cache->isError = 1;
+    return;
+  }
+  cache->received += dataLen;
+}
+
+#endif /* QTEL_EN_FEATURE_HTTP */
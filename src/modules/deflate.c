@@ -0,0 +1,240 @@
+/*
+ * deflate.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel/conf.h"
+#include "../include/quectel/deflate.h"
+#include "../include/quectel/digest.h"
+#include <string.h>
+
+#if QTEL_EN_FEATURE_DEFLATE
+
+#define WINDOW_MASK (QTEL_DEFLATE_WINDOW_SIZE - 1)
+#define MIN_MATCH   3
+#define MAX_MATCH   258
+#define MAX_DIST    (QTEL_DEFLATE_WINDOW_SIZE - MAX_MATCH - 1)
+
+static const uint16_t lengthBase[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t lengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t distBase[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t distExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static void     encode(QTEL_Deflate_t*);
+static uint16_t hash(QTEL_Deflate_t*, uint32_t pos);
+static void     putSymbol(QTEL_Deflate_t*, uint16_t symbol);
+static void     putMatch(QTEL_Deflate_t*, uint16_t length, uint16_t dist);
+static void     putCode(QTEL_Deflate_t*, uint16_t code, uint8_t n);
+static void     putBits(QTEL_Deflate_t*, uint32_t value, uint8_t n);
+static void     putByte(QTEL_Deflate_t*, uint8_t b);
+static void     flush(QTEL_Deflate_t*);
+
+
+void QTEL_Deflate_Begin(QTEL_Deflate_t *def, uint8_t format, QTEL_Deflate_Output_Func onOutput, void *ctx)
+{
+  static const uint8_t gzipHeader[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+  uint8_t i;
+
+  def->onOutput = onOutput;
+  def->ctx = ctx;
+  def->format = format;
+  def->bitBuf = 0;
+  def->bitCnt = 0;
+  def->pos = 0;
+  def->inEnd = 0;
+  def->crc = 0;
+  def->outLen = 0;
+  memset(def->head, 0, sizeof(def->head));
+
+  if (format == QTEL_DEFLATE_FORMAT_GZIP) {
+    for (i = 0; i < sizeof(gzipHeader); i++) putByte(def, gzipHeader[i]);
+  }
+
+  // not final, fixed Huffman
+  putBits(def, 0, 1);
+  putBits(def, 1, 2);
+}
+
+
+/**
+ * input is encoded when the longest match can be looked up,
+ * the rest waits in the window until the next write or finish
+ */
+void QTEL_Deflate_Write(QTEL_Deflate_t *def, const uint8_t *data, uint16_t length)
+{
+  if (def->format == QTEL_DEFLATE_FORMAT_GZIP)
+    def->crc = QTEL_CRC32_Update(def->crc, data, length);
+
+  while (length--) {
+    def->window[def->inEnd & WINDOW_MASK] = *data++;
+    def->inEnd++;
+    while (def->inEnd - def->pos > MAX_MATCH) encode(def);
+  }
+}
+
+
+void QTEL_Deflate_Finish(QTEL_Deflate_t *def)
+{
+  uint8_t i;
+
+  while (def->pos < def->inEnd) encode(def);
+  putSymbol(def, 256);
+
+  // empty final block, then the byte is completed
+  putBits(def, 1, 1);
+  putBits(def, 1, 2);
+  putSymbol(def, 256);
+  if (def->bitCnt > 0) putBits(def, 0, 8 - def->bitCnt);
+
+  if (def->format == QTEL_DEFLATE_FORMAT_GZIP) {
+    for (i = 0; i < 4; i++) putByte(def, (uint8_t) (def->crc >> (i * 8)));
+    for (i = 0; i < 4; i++) putByte(def, (uint8_t) (def->inEnd >> (i * 8)));
+  }
+  flush(def);
+}
+
+
+/**
+ * maximum output which isn't passed to onOutput yet,
+ * if length more bytes are written and then finished
+ */
+uint32_t QTEL_Deflate_GetBound(QTEL_Deflate_t *def, uint32_t length)
+{
+  // literal is 9 bits at most, match is never longer per byte
+  uint32_t bits = (def->inEnd - def->pos + length) * 9 + def->bitCnt + 7 + 3 + 7 + 7;
+
+  return def->outLen + bits / 8 + ((def->format == QTEL_DEFLATE_FORMAT_GZIP)? 8 : 0);
+}
+
+
+static void encode(QTEL_Deflate_t *def)
+{
+  uint32_t  avail   = def->inEnd - def->pos;
+  uint16_t  maxLen  = (avail < MAX_MATCH)? (uint16_t) avail : MAX_MATCH;
+  uint16_t  length  = 0;
+  uint16_t  dist    = 0;
+  uint16_t  h;
+  uint16_t  i;
+
+  if (avail >= MIN_MATCH) {
+    h = hash(def, def->pos);
+    dist = (uint16_t) def->pos - def->head[h];
+    def->head[h] = (uint16_t) def->pos;
+
+    // the hash slot may be stale, a match is taken only by the bytes
+    if (dist > 0 && dist <= MAX_DIST && dist <= def->pos) {
+      while (length < maxLen
+             && def->window[(def->pos - dist + length) & WINDOW_MASK]
+                == def->window[(def->pos + length) & WINDOW_MASK])
+      {
+        length++;
+      }
+    }
+  }
+
+  if (length < MIN_MATCH) {
+    putSymbol(def, def->window[def->pos & WINDOW_MASK]);
+    def->pos++;
+    return;
+  }
+
+  putMatch(def, length, dist);
+  for (i = 1; i < length; i++) {
+    if (def->inEnd - (def->pos + i) < MIN_MATCH) break;
+    def->head[hash(def, def->pos + i)] = (uint16_t) (def->pos + i);
+  }
+  def->pos += length;
+}
+
+
+static uint16_t hash(QTEL_Deflate_t *def, uint32_t pos)
+{
+  uint32_t key = ((uint32_t) def->window[pos & WINDOW_MASK] << 16)
+                 | ((uint32_t) def->window[(pos + 1) & WINDOW_MASK] << 8)
+                 | def->window[(pos + 2) & WINDOW_MASK];
+
+  return (uint16_t) (((key * 2654435761U) >> 16) & (QTEL_DEFLATE_HASH_SIZE - 1));
+}
+
+
+static void putSymbol(QTEL_Deflate_t *def, uint16_t symbol)
+{
+  if (symbol < 144)       putCode(def, 0x30 + symbol, 8);
+  else if (symbol < 256)  putCode(def, 0x190 + symbol - 144, 9);
+  else if (symbol < 280)  putCode(def, symbol - 256, 7);
+  else                    putCode(def, 0xC0 + symbol - 280, 8);
+}
+
+
+static void putMatch(QTEL_Deflate_t *def, uint16_t length, uint16_t dist)
+{
+  uint8_t i = 28;
+
+  while (lengthBase[i] > length) i--;
+  putSymbol(def, 257 + i);
+  putBits(def, length - lengthBase[i], lengthExtra[i]);
+
+  i = 29;
+  while (distBase[i] > dist) i--;
+  putCode(def, i, 5);
+  putBits(def, dist - distBase[i], distExtra[i]);
+}
+
+
+/*
+ * Huffman code is sent from its most significant bit
+ */
+static void putCode(QTEL_Deflate_t *def, uint16_t code, uint8_t n)
+{
+  uint16_t  reversed = 0;
+  uint8_t   i;
+
+  for (i = 0; i < n; i++) {
+    reversed = (reversed << 1) | (code & 1);
+    code >>= 1;
+  }
+  putBits(def, reversed, n);
+}
+
+
+static void putBits(QTEL_Deflate_t *def, uint32_t value, uint8_t n)
+{
+  def->bitBuf |= value << def->bitCnt;
+  def->bitCnt += n;
+  while (def->bitCnt >= 8) {
+    putByte(def, (uint8_t) def->bitBuf);
+    def->bitBuf >>= 8;
+    def->bitCnt -= 8;
+  }
+}
+
+
+static void putByte(QTEL_Deflate_t *def, uint8_t b)
+{
+  def->out[def->outLen++] = b;
+  if (def->outLen == sizeof(def->out)) flush(def);
+}
+
+
+static void flush(QTEL_Deflate_t *def)
+{
+  if (def->outLen == 0) return;
+  if (def->onOutput != NULL) def->onOutput(def->ctx, def->out, def->outLen);
+  def->outLen = 0;
+}
+
+#endif /* QTEL_EN_FEATURE_DEFLATE */
@@ -0,0 +1,166 @@
+/*
+ * digest.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel/digest.h"
+#include <string.h>
+
+#define ROTR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const uint32_t sha256K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static void sha256Transform(QTEL_SHA256_t*, const uint8_t *block);
+
+
+/**
+ * half-byte table, small enough for flash of small MCU
+ */
+uint32_t QTEL_CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+  };
+
+  crc = ~crc;
+  while (length--) {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+
+/**
+ * 5552 bytes is the longest run before the sums can overflow 32 bit
+ */
+uint32_t QTEL_Adler32_Update(uint32_t adler, const uint8_t *data, uint32_t length)
+{
+  uint32_t a = adler & 0xFFFF;
+  uint32_t b = adler >> 16;
+  uint32_t n;
+
+  while (length) {
+    n = (length < 5552)? length : 5552;
+    length -= n;
+    while (n--) {
+      a += *data++;
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+  }
+  return (b << 16) | a;
+}
+
+
+void QTEL_SHA256_Init(QTEL_SHA256_t *ctx)
+{
+  ctx->state[0] = 0x6a09e667;
+  ctx->state[1] = 0xbb67ae85;
+  ctx->state[2] = 0x3c6ef372;
+  ctx->state[3] = 0xa54ff53a;
+  ctx->state[4] = 0x510e527f;
+  ctx->state[5] = 0x9b05688c;
+  ctx->state[6] = 0x1f83d9ab;
+  ctx->state[7] = 0x5be0cd19;
+  ctx->lengthLow = 0;
+  ctx->lengthHigh = 0;
+  ctx->blockLen = 0;
+}
+
+
+void QTEL_SHA256_Update(QTEL_SHA256_t *ctx, const uint8_t *data, uint32_t length)
+{
+  uint32_t copyLen;
+
+  ctx->lengthLow += length;
+  if (ctx->lengthLow < length) ctx->lengthHigh++;
+
+  while (length) {
+    copyLen = 64 - ctx->blockLen;
+    if (copyLen > length) copyLen = length;
+    memcpy(&ctx->block[ctx->blockLen], data, copyLen);
+    ctx->blockLen += copyLen;
+    data += copyLen;
+    length -= copyLen;
+
+    if (ctx->blockLen == 64) {
+      sha256Transform(ctx, ctx->block);
+      ctx->blockLen = 0;
+    }
+  }
+}
+
+
+void QTEL_SHA256_Final(QTEL_SHA256_t *ctx, uint8_t digest[QTEL_SHA256_SIZE])
+{
+  uint32_t  bitsHigh = (ctx->lengthHigh << 3) | (ctx->lengthLow >> 29);
+  uint32_t  bitsLow = ctx->lengthLow << 3;
+  uint8_t   i;
+
+  ctx->block[ctx->blockLen++] = 0x80;
+  if (ctx->blockLen > 56) {
+    memset(&ctx->block[ctx->blockLen], 0, 64 - ctx->blockLen);
+    sha256Transform(ctx, ctx->block);
+    ctx->blockLen = 0;
+  }
+  memset(&ctx->block[ctx->blockLen], 0, 56 - ctx->blockLen);
+
+  for (i = 0; i < 4; i++) {
+    ctx->block[56 + i] = (uint8_t) (bitsHigh >> (24 - i * 8));
+    ctx->block[60 + i] = (uint8_t) (bitsLow >> (24 - i * 8));
+  }
+  sha256Transform(ctx, ctx->block);
+
+  for (i = 0; i < 32; i++) {
+    digest[i] = (uint8_t) (ctx->state[i >> 2] >> (24 - (i & 3) * 8));
+  }
+}
+
+
+static void sha256Transform(QTEL_SHA256_t *ctx, const uint8_t *block)
+{
+  uint32_t w[64];
+  uint32_t a, b, c, d, e, f, g, h;
+  uint32_t t1, t2;
+  uint8_t  i;
+
+  for (i = 0; i < 16; i++) {
+    w[i] = ((uint32_t) block[i*4] << 24) | ((uint32_t) block[i*4+1] << 16)
+           | ((uint32_t) block[i*4+2] << 8) | (uint32_t) block[i*4+3];
+  }
+  for (i = 16; i < 64; i++) {
+    t1 = ROTR(w[i-2], 17) ^ ROTR(w[i-2], 19) ^ (w[i-2] >> 10);
+    t2 = ROTR(w[i-15], 7) ^ ROTR(w[i-15], 18) ^ (w[i-15] >> 3);
+    w[i] = w[i-16] + t2 + w[i-7] + t1;
+  }
+
+  a = ctx->state[0]; b = ctx->state[1]; c = ctx->state[2]; d = ctx->state[3];
+  e = ctx->state[4]; f = ctx->state[5]; g = ctx->state[6]; h = ctx->state[7];
+
+  for (i = 0; i < 64; i++) {
+    t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+    t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g; g = f; f = e;
+    e = d + t1;
+    d = c; c = b; b = a;
+    a = t1 + t2;
+  }
+
+  ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
+  ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+}
@@ -0,0 +1,323 @@
+/*
+ * dns.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/net.h"
+#include "../include/quectel/dns.h"
+#include "../include/quectel/socket.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_DNS
+
+#define DNSGIP_URC      "+QIURC: \"dnsgip\","
+#define DNSGIP_URC_LEN  17
+
+static int8_t         findCache(QTEL_HandlerTypeDef*, const char *host);
+static int8_t         allocCache(QTEL_HandlerTypeDef*);
+static QTEL_Status_t  startResolving(QTEL_HandlerTypeDef*, uint8_t idx);
+static void           finishResolving(QTEL_HandlerTypeDef*, uint8_t status);
+static uint8_t        isIPAddress(const char *host);
+
+
+/*
+ * +QIURC: "dnsgip",<err>,<IP_count>,<DNS_ttl>
+ * +QIURC: "dnsgip","<IP_addr>"   (IP_count lines)
+ */
+uint8_t QTEL_DNS_CheckAsyncResponse(QTEL_HandlerTypeDef *hqtel)
+{
+  uint8_t       isGet   = 0;
+  char          strTmp[QTEL_DNS_IP_SIZE];   // URC may come while respTmp is in use
+  const uint8_t *nextBuf;
+  uint16_t      err;
+  uint8_t       ipCount;
+
+  if ((isGet = (hqtel->respBufferLen > DNSGIP_URC_LEN && QTEL_IsResponse(hqtel, DNSGIP_URC, DNSGIP_URC_LEN)))) {
+    if (hqtel->net.dns.resolving == 0) return isGet;
+    nextBuf = &hqtel->respBuffer[DNSGIP_URC_LEN];
+
+    if (*nextBuf == '\"') {
+      // use first address, keep the old one valid until it's replaced
+      if (hqtel->net.dns.ipLeft == 0) return isGet;
+      if (hqtel->net.dns.ipLeft == 0xFF) {
+        memset(strTmp, 0, QTEL_DNS_IP_SIZE);
+        QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+        strncpy(hqtel->net.dns.cache[hqtel->net.dns.resolving-1].ip, strTmp, QTEL_DNS_IP_SIZE-1);
+        hqtel->net.dns.ipLeft = 0;
+        finishResolving(hqtel, QTEL_DNS_STATUS_RESOLVED);
+      }
+      return isGet;
+    }
+
+    memset(strTmp, 0, 6);
+    nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+    err = (uint16_t) atoi(strTmp);
+
+    memset(strTmp, 0, 4);
+    nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+    ipCount = (uint8_t) atoi(strTmp);
+
+    memset(strTmp, 0, 11);
+    QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+    hqtel->net.dns.cache[hqtel->net.dns.resolving-1].ttl = (uint32_t) atol(strTmp) * 1000;
+    hqtel->net.dns.cache[hqtel->net.dns.resolving-1].error = err;
+
+    if (err != 0 || ipCount == 0) {
+      finishResolving(hqtel, QTEL_DNS_STATUS_ERROR);
+    } else {
+      // wait for the first IP line
+      hqtel->net.dns.ipLeft = 0xFF;
+    }
+  }
+
+  return isGet;
+}
+
+
+void QTEL_DNS_HandleEvents(QTEL_HandlerTypeDef *hqtel)
+{
+  uint8_t i;
+  uint32_t refreshAt;
+
+  if (hqtel->net.dns.resolving) {
+    if (QTEL_IsTimeout(hqtel->net.dns.cache[hqtel->net.dns.resolving-1].requestTick, QTEL_DNS_TIMEOUT)) {
+      hqtel->net.dns.cache[hqtel->net.dns.resolving-1].error = QTEL_DNS_ERR_TIMEOUT;
+      finishResolving(hqtel, QTEL_DNS_STATUS_ERROR);
+    }
+    else return;
+  }
+
+  if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) return;
+
+  for (i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.cache[i].status == QTEL_DNS_STATUS_QUEUED) {
+      startResolving(hqtel, i);
+      return;
+    }
+  }
+
+  // pre-resolve host which is still used before its TTL is over
+  for (i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.cache[i].status != QTEL_DNS_STATUS_RESOLVED
+        || !hqtel->net.dns.cache[i].isUsed)
+    {
+      continue;
+    }
+    refreshAt = hqtel->net.dns.cache[i].ttl - (hqtel->net.dns.cache[i].ttl / 10);
+    if (QTEL_IsTimeout(hqtel->net.dns.cache[i].resolvedTick, refreshAt)) {
+      startResolving(hqtel, i);
+      return;
+    }
+  }
+}
+
+
+/**
+ * request resolving host in background,
+ * result will be kept in cache until its TTL is over
+ */
+QTEL_Status_t QTEL_DNS_Resolve(QTEL_HandlerTypeDef *hqtel, const char *host)
+{
+  int8_t idx;
+
+  if (strlen(host) >= QTEL_DNS_HOST_SIZE) return QTEL_ERROR;
+
+  idx = findCache(hqtel, host);
+  if (idx < 0) {
+    idx = allocCache(hqtel);
+    if (idx < 0) return QTEL_ERROR;
+    memset(&hqtel->net.dns.cache[idx], 0, sizeof(hqtel->net.dns.cache[idx]));
+    strcpy(hqtel->net.dns.cache[idx].host, host);
+  }
+
+  if (hqtel->net.dns.cache[idx].status == QTEL_DNS_STATUS_RESOLVING
+      || hqtel->net.dns.cache[idx].status == QTEL_DNS_STATUS_QUEUED)
+  {
+    return QTEL_OK;
+  }
+
+  hqtel->net.dns.cache[idx].lastUsedTick = QTEL_GetTick();
+
+  if (hqtel->net.dns.resolving || !QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) {
+    hqtel->net.dns.cache[idx].status = QTEL_DNS_STATUS_QUEUED;
+    return QTEL_OK;
+  }
+
+  return startResolving(hqtel, (uint8_t) idx);
+}
+
+
+/**
+ * copy address of host into ip (QTEL_DNS_IP_SIZE)
+ * return QTEL_OK if it's available,
+ *        QTEL_BUSY if it's being resolved,
+ *        QTEL_ERROR if it's not resolved yet or failed
+ */
+QTEL_Status_t QTEL_DNS_Lookup(QTEL_HandlerTypeDef *hqtel, const char *host, char *ip)
+{
+  int8_t idx;
+
+  if (isIPAddress(host)) {
+    strncpy(ip, host, QTEL_DNS_IP_SIZE-1);
+    ip[QTEL_DNS_IP_SIZE-1] = 0;
+    return QTEL_OK;
+  }
+
+  idx = findCache(hqtel, host);
+  if (idx < 0) return QTEL_ERROR;
+
+  hqtel->net.dns.cache[idx].lastUsedTick = QTEL_GetTick();
+  hqtel->net.dns.cache[idx].isUsed = 1;
+
+  if (hqtel->net.dns.cache[idx].ip[0] != 0
+      && !QTEL_IsTimeout(hqtel->net.dns.cache[idx].resolvedTick, hqtel->net.dns.cache[idx].ttl))
+  {
+    strcpy(ip, hqtel->net.dns.cache[idx].ip);
+    return QTEL_OK;
+  }
+
+  if (hqtel->net.dns.cache[idx].status == QTEL_DNS_STATUS_RESOLVING
+      || hqtel->net.dns.cache[idx].status == QTEL_DNS_STATUS_QUEUED)
+  {
+    return QTEL_BUSY;
+  }
+
+  return QTEL_ERROR;
+}
+
+
+uint32_t QTEL_DNS_GetResolveTime(QTEL_HandlerTypeDef *hqtel, const char *host)
+{
+  int8_t idx = findCache(hqtel, host);
+
+  if (idx < 0) return 0;
+  return hqtel->net.dns.cache[idx].resolveTime;
+}
+
+
+uint16_t QTEL_DNS_GetError(QTEL_HandlerTypeDef *hqtel, const char *host)
+{
+  int8_t idx = findCache(hqtel, host);
+
+  if (idx < 0) return 0;
+  return hqtel->net.dns.cache[idx].error;
+}
+
+
+void QTEL_DNS_Flush(QTEL_HandlerTypeDef *hqtel)
+{
+  for (uint8_t i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.resolving == i+1) continue;
+    if (hqtel->net.dns.cache[i].status == QTEL_DNS_STATUS_QUEUED) continue;
+    memset(&hqtel->net.dns.cache[i], 0, sizeof(hqtel->net.dns.cache[i]));
+  }
+}
+
+
+static int8_t findCache(QTEL_HandlerTypeDef *hqtel, const char *host)
+{
+  for (uint8_t i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.cache[i].status != QTEL_DNS_STATUS_EMPTY
+        && strcmp(hqtel->net.dns.cache[i].host, host) == 0)
+    {
+      return (int8_t) i;
+    }
+  }
+  return -1;
+}
+
+
+/*
+ * get empty cache, or failed one, or the least recently used
+ */
+static int8_t allocCache(QTEL_HandlerTypeDef *hqtel)
+{
+  int8_t  idx = -1;
+  uint8_t i;
+
+  for (i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.cache[i].status == QTEL_DNS_STATUS_EMPTY) return (int8_t) i;
+  }
+
+  for (i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.cache[i].status == QTEL_DNS_STATUS_ERROR) return (int8_t) i;
+  }
+
+  for (i = 0; i < QTEL_DNS_CACHE_SIZE; i++) {
+    if (hqtel->net.dns.cache[i].status != QTEL_DNS_STATUS_RESOLVED) continue;
+    if (idx < 0
+        || (QTEL_GetTick() - hqtel->net.dns.cache[i].lastUsedTick)
+           > (QTEL_GetTick() - hqtel->net.dns.cache[idx].lastUsedTick))
+    {
+      idx = (int8_t) i;
+    }
+  }
+
+  return idx;
+}
+
+
+static QTEL_Status_t startResolving(QTEL_HandlerTypeDef *hqtel, uint8_t idx)
+{
+  QTEL_Status_t status = QTEL_ERROR;
+
+  hqtel->net.dns.resolving  = idx+1;
+  hqtel->net.dns.ipLeft     = 0;
+  hqtel->net.dns.cache[idx].status      = QTEL_DNS_STATUS_RESOLVING;
+  hqtel->net.dns.cache[idx].isUsed      = 0;
+  hqtel->net.dns.cache[idx].requestTick = QTEL_GetTick();
+
+  QTEL_LOCK(hqtel);
+  QTEL_SendCMD(hqtel, "AT+QIDNSGIP=%u,\"%s\"", (uint) hqtel->net.contextId, hqtel->net.dns.cache[idx].host);
+  if (!QTEL_IsResponseOK(hqtel)) {
+    // the response may be finished while waiting OK
+    if (hqtel->net.dns.resolving == idx+1) {
+      finishResolving(hqtel, QTEL_DNS_STATUS_ERROR);
+    }
+    goto endcmd;
+  }
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+static void finishResolving(QTEL_HandlerTypeDef *hqtel, uint8_t status)
+{
+  uint8_t idx = hqtel->net.dns.resolving-1;
+
+  hqtel->net.dns.resolving = 0;
+  hqtel->net.dns.ipLeft = 0;
+  hqtel->net.dns.cache[idx].status = status;
+  hqtel->net.dns.cache[idx].resolveTime = QTEL_GetTick() - hqtel->net.dns.cache[idx].requestTick;
+
+  if (status == QTEL_DNS_STATUS_RESOLVED) {
+    hqtel->net.dns.cache[idx].resolvedTick = QTEL_GetTick();
+  } else {
+    QTEL_Debug("[DNS] %s error - %d", hqtel->net.dns.cache[idx].host, hqtel->net.dns.cache[idx].error);
+  }
+
+  QTEL_SockOnResolved(hqtel, hqtel->net.dns.cache[idx].host);
+}
+
+
+static uint8_t isIPAddress(const char *host)
+{
+  if (*host == 0) return 0;
+
+  for (; *host; host++) {
+    if (*host == ':') return 1; // IPv6
+    if (*host != '.' && (*host < '0' || *host > '9')) return 0;
+  }
+  return 1;
+}
+
+#endif /* QTEL_EN_FEATURE_DNS */
@@ -0,0 +1,244 @@
+/*
+ * download.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/net.h"
+#include "../include/quectel/http.h"
+#include "../include/quectel/file.h"
+#include "../include/quectel/digest.h"
+#include "../include/quectel/download.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdio.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_HTTP
+
+#define STATE_FILE_FORMAT "%s.dl"
+
+static void           loadState(QTEL_HandlerTypeDef*, QTEL_HTTP_Download_t*, const char *stateFilename);
+static QTEL_Status_t  saveState(QTEL_HandlerTypeDef*, QTEL_HTTP_Download_t*, const char *stateFilename);
+static void           resetState(QTEL_HTTP_Download_t*);
+static QTEL_Status_t  requestChunk(QTEL_HandlerTypeDef*, QTEL_HTTP_Download_t*, uint32_t length);
+static void           writeChunk(QTEL_HandlerTypeDef*, const uint8_t *data, uint16_t dataLen, uint32_t maxLen);
+static uint8_t        verify(QTEL_HTTP_Download_t*);
+
+
+/**
+ * download in range chunks into UFS file, progress is saved after each chunk
+ * so the download is resumed by calling it again after error or restart
+ */
+QTEL_Status_t QTEL_HTTP_Download(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Download_t *dl)
+{
+  QTEL_Status_t status;
+  char          stateFilename[QTEL_DOWNLOAD_FILENAME_SIZE];
+  uint32_t      reqLen;
+  uint8_t       retry = 0;
+  uint8_t       readMode = hqtel->HTTP.readMode;
+
+  if (dl->chunkSize == 0 || dl->buffer == NULL || dl->bufferSize == 0) return QTEL_ERROR;
+  if (snprintf(stateFilename, sizeof(stateFilename), STATE_FILE_FORMAT, dl->filename)
+      >= (int) sizeof(stateFilename))
+  {
+    return QTEL_ERROR;
+  }
+
+  loadState(hqtel, dl, stateFilename);
+  status = QTEL_File_Open(hqtel, &dl->file, QTEL_File_Storage_UFS, dl->filename);
+  if (status != QTEL_OK) return status;
+
+  // reader writes into the file, so the response must be read from RAM file
+  hqtel->HTTP.readMode = QTEL_HTTP_READ_FILE;
+  hqtel->HTTP.downloadTmpPtr = dl;
+
+  while (dl->totalSize == 0 || dl->state.offset < dl->totalSize) {
+    reqLen = dl->chunkSize;
+    if (dl->totalSize != 0 && reqLen > dl->totalSize - dl->state.offset)
+      reqLen = dl->totalSize - dl->state.offset;
+
+    status = requestChunk(hqtel, dl, reqLen);
+
+    if (status == QTEL_OK && hqtel->HTTP.response.code == 416) {
+      // range is over, previous chunk was the last one
+      break;
+    }
+    if (status == QTEL_OK && hqtel->HTTP.response.code == 200 && dl->state.offset > 0) {
+      // range is ignored, data was written at wrong position so take it again from zero
+      resetState(dl);
+      saveState(hqtel, dl, stateFilename);
+      continue;
+    }
+    if (status != QTEL_OK || dl->chunk.isError
+        || (hqtel->HTTP.response.code != 206 && hqtel->HTTP.response.code != 200))
+    {
+      if (++retry > dl->retryMax) {
+        status = QTEL_ERROR;
+        goto endDownload;
+      }
+      QTEL_NET_WaitOnline(hqtel, dl->timeout);
+      continue;
+    }
+    retry = 0;
+
+    dl->state.offset += dl->chunk.received;
+    dl->state.crc = dl->chunk.crc;
+    dl->state.sha256 = dl->chunk.sha256;
+    saveState(hqtel, dl, stateFilename);
+    if (dl->onProgress != NULL) dl->onProgress(dl->state.offset, dl->totalSize);
+
+    // whole content or last chunk
+    if (hqtel->HTTP.response.code == 200 || dl->chunk.received < reqLen) break;
+  }
+
+  // drop data of unfinished chunk or older file
+  status = QTEL_File_Seek(&dl->file, dl->state.offset);
+  if (status == QTEL_OK) status = QTEL_File_Truncate(&dl->file);
+  if (status != QTEL_OK) goto endDownload;
+
+  if (!verify(dl)) {
+    // corrupted, next download is started from zero
+    QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, stateFilename);
+    status = QTEL_ERROR;
+    goto endDownload;
+  }
+  QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, stateFilename);
+  status = QTEL_OK;
+
+  endDownload:
+  QTEL_File_Close(&dl->file);
+  hqtel->HTTP.downloadTmpPtr = NULL;
+  hqtel->HTTP.readMode = readMode;
+  return status;
+}
+
+
+/**
+ * forget the progress, next download is started from zero
+ */
+QTEL_Status_t QTEL_HTTP_CancelDownload(QTEL_HandlerTypeDef *hqtel, const char *filename)
+{
+  char stateFilename[QTEL_DOWNLOAD_FILENAME_SIZE];
+
+  if (snprintf(stateFilename, sizeof(stateFilename), STATE_FILE_FORMAT, filename)
+      >= (int) sizeof(stateFilename))
+  {
+    return QTEL_ERROR;
+  }
+  return QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, stateFilename);
+}
+
+
+/*
+ * state is used only if it belongs to the same URL
+ */
+static void loadState(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Download_t *dl, const char *stateFilename)
+{
+  QTEL_File_t stateFile;
+  int32_t     readLen = -1;
+  uint32_t    urlHash = QTEL_CRC32_Update(0, (const uint8_t*) dl->url, strlen(dl->url));
+
+  if (QTEL_File_Open(hqtel, &stateFile, QTEL_File_Storage_UFS, stateFilename) == QTEL_OK) {
+    if (stateFile.length == sizeof(dl->state))
+      readLen = QTEL_File_Read(&stateFile, (uint8_t*) &dl->state, sizeof(dl->state));
+    QTEL_File_Close(&stateFile);
+  }
+
+  if (readLen != (int32_t) sizeof(dl->state)
+      || dl->state.magic != QTEL_DOWNLOAD_STATE_MAGIC
+      || dl->state.urlHash != urlHash)
+  {
+    resetState(dl);
+    dl->state.urlHash = urlHash;
+  }
+}
+
+
+static QTEL_Status_t saveState(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Download_t *dl, const char *stateFilename)
+{
+  QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, stateFilename);
+  return QTEL_File_Upload(hqtel, QTEL_File_Storage_UFS, stateFilename,
+                          (uint8_t*) &dl->state, sizeof(dl->state));
+}
+
+
+static void resetState(QTEL_HTTP_Download_t *dl)
+{
+  uint32_t urlHash = dl->state.urlHash;
+
+  memset(&dl->state, 0, sizeof(dl->state));
+  dl->state.magic = QTEL_DOWNLOAD_STATE_MAGIC;
+  dl->state.urlHash = urlHash;
+  QTEL_SHA256_Init(&dl->state.sha256);
+}
+
+
+static QTEL_Status_t requestChunk(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Download_t *dl, uint32_t length)
+{
+  QTEL_HTTP_Request_t req;
+  char                rangeHeader[48];
+
+  dl->chunk.received = 0;
+  dl->chunk.crc = dl->state.crc;
+  dl->chunk.sha256 = dl->state.sha256;
+  dl->chunk.isError = 0;
+
+  sprintf(rangeHeader, "Range: bytes=%lu-%lu",
+          (unsigned long) dl->state.offset, (unsigned long) (dl->state.offset + length - 1));
+  if (QTEL_File_Seek(&dl->file, dl->state.offset) != QTEL_OK) return QTEL_ERROR;
+
+  memset(&req, 0, sizeof(QTEL_HTTP_Request_t));
+  req.method = QTEL_HTTP_GET;
+  req.url = dl->url;
+  req.timeout = dl->timeout;
+  req.customHeader = rangeHeader;
+  req.onContent = writeChunk;
+  req.contentBuf = dl->buffer;
+  req.contentBufLen = dl->bufferSize;
+  return QTEL_HTTP_Send(hqtel, &req);
+}
+
+
+static void writeChunk(QTEL_HandlerTypeDef *hqtel, const uint8_t *data, uint16_t dataLen, uint32_t maxLen)
+{
+  QTEL_HTTP_Download_t *dl = (QTEL_HTTP_Download_t*) hqtel->HTTP.downloadTmpPtr;
+
+  if (dl == NULL || dl->chunk.isError) return;
+
+  // response of error code isn't the content
+  if (hqtel->HTTP.response.code != 200 && hqtel->HTTP.response.code != 206) return;
+
+  if (QTEL_File_Write(&dl->file, data, dataLen) != (int32_t) dataLen) {
+    dl->chunk.isError = 1;
+    return;
+  }
+
+  if (dl->digestType == QTEL_DIGEST_CRC32)
+    dl->chunk.crc = QTEL_CRC32_Update(dl->chunk.crc, data, dataLen);
+  else if (dl->digestType == QTEL_DIGEST_SHA256)
+    QTEL_SHA256_Update(&dl->chunk.sha256, data, dataLen);
+  dl->chunk.received += dataLen;
+}
+
+
+static uint8_t verify(QTEL_HTTP_Download_t *dl)
+{
+  uint8_t digest[QTEL_SHA256_SIZE];
+
+  if (dl->totalSize != 0 && dl->state.offset != dl->totalSize) return 0;
+
+  if (dl->digestType == QTEL_DIGEST_CRC32)
+    return dl->state.crc == dl->expectedCRC;
+
+  if (dl->digestType == QTEL_DIGEST_SHA256 && dl->expectedSHA256 != NULL) {
+    QTEL_SHA256_Final(&dl->state.sha256, digest);
+    return memcmp(digest, dl->expectedSHA256, QTEL_SHA256_SIZE) == 0;
+  }
+
+  return 1;
+}
+
+#endif /* QTEL_EN_FEATURE_HTTP */
@@ -8,6 +8,7 @@
 #include "../include/quectel/file.h"
 #include "../include/quectel/utils.h"
 #include <stdlib.h>
+#include <string.h>
 
 static char* StorageStr[QTEL_File_Storage_MAX]= {
     "",
@@ -15,6 +16,13 @@ static char* StorageStr[QTEL_File_Storage_MAX]= {
     "SD"
 };
 
+static QTEL_Status_t  getLength(QTEL_HandlerTypeDef*, QTEL_File_Storage_t, const char *filename,
+                                uint32_t *length);
+static const uint8_t  *readMemory(void *ctx, uint32_t offset, uint16_t *length);
+static uint16_t       updateChecksum(uint16_t checksum, uint32_t offset, const uint8_t *data, uint16_t length);
+static QTEL_Status_t  syncPos(QTEL_BFile_t*, uint32_t offset);
+static void           abortUpload(QTEL_HandlerTypeDef*, uint32_t sent, uint32_t fileSize, uint8_t isWaitAck);
+
 
 QTEL_Status_t QTEL_File_Upload(QTEL_HandlerTypeDef *hqtel,
                                QTEL_File_Storage_t storage,
@@ -22,67 +30,165 @@ QTEL_Status_t QTEL_File_Upload(QTEL_HandlerTypeDef *hqtel,
                                uint8_t *data,
                                uint16_t dataLen)
 {
-  QTEL_Status_t status = QTEL_ERROR;
-  uint8_t *resp = &hqtel->respTmp[0];
+  return QTEL_File_UploadStream(hqtel, storage, filename, dataLen, readMemory, data);
+}
+
+
+/**
+ * upload in ack mode, the modem acks each 1024 bytes with "A".
+ * next slice is taken from source while the modem is writing,
+ * size and checksum of +QFUPL are checked at the end
+ */
+QTEL_Status_t QTEL_File_UploadStream(QTEL_HandlerTypeDef *hqtel,
+                                     QTEL_File_Storage_t storage,
+                                     const char *filename,
+                                     uint32_t fileSize,
+                                     QTEL_File_Source_Func source,
+                                     void *ctx)
+{
+  QTEL_Status_t status   = QTEL_ERROR;
+  uint8_t       *resp    = &hqtel->respTmp[0];
+  char          *strTmp  = (char*) &hqtel->respTmp[24];
+  const uint8_t *data;
+  const uint8_t *nextBuf;
+  uint32_t      sent     = 0;
+  uint16_t      sliceLen;
+  uint16_t      checksum = 0;
+  uint8_t       isWaitAck = 0;
+  uint8_t       isAborted = 0;
 
   QTEL_LOCK(hqtel);
   QTEL_SendCMD(hqtel,
-               "AT+QFUPL=\"%s%s%s\",%d,60,1",
+               "AT+QFUPL=\"%s%s%s\",%lu,%u,1",
                StorageStr[storage], (storage>0)?":":"", filename,
-               dataLen);
+               (unsigned long) fileSize, QTEL_FILE_UPLOAD_TIMEOUT);
 
   if (!QTEL_WaitResponse(hqtel, "CONNECT", 7, 5000))
     goto endcmd;
 
-  while (dataLen) {
-    if (!QTEL_SendData(hqtel, data, (dataLen < 1024)? dataLen:1024))
-      goto endcmd;
+  while (sent < fileSize) {
+    // slice doesn't cross the ack boundary
+    sliceLen = 1024 - (uint16_t) (sent % 1024);
+    if (sliceLen > fileSize - sent) sliceLen = (uint16_t) (fileSize - sent);
 
-    if (dataLen < 1024) {
-      memset(resp, 0, 24);
-      if (QTEL_GetResponse(hqtel, "+QFUPL", 6, resp, 24, QTEL_GETRESP_WAIT_OK, 5000) != QTEL_OK)
-        goto endcmd;
-      break;
+    data = source(ctx, sent, &sliceLen);
+    if (data == NULL || sliceLen == 0) {
+      abortUpload(hqtel, sent, fileSize, isWaitAck);
+      isAborted = 1;
+      goto endcmd;
     }
-    else {
-      if (!QTEL_WaitResponse(hqtel, "A", 1, 5000))
-        goto endcmd;
-      dataLen -= 1024;
-      data += 1024;
+
+    if (isWaitAck && !QTEL_WaitResponse(hqtel, "A", 1, 5000))
+      goto endcmd;
+
+    if (!QTEL_SendData(hqtel, data, sliceLen)) {
+      abortUpload(hqtel, sent, fileSize, 0);
+      isAborted = 1;
+      goto endcmd;
     }
+    checksum = updateChecksum(checksum, sent, data, sliceLen);
+    sent += sliceLen;
+    isWaitAck = (sent % 1024 == 0);
   }
+
+  memset(resp, 0, 24);
+  if (QTEL_GetResponse(hqtel, "+QFUPL", 6, resp, 24, QTEL_GETRESP_WAIT_OK, 5000) != QTEL_OK)
+    goto endcmd;
+
+  // +QFUPL: <upload_size>,<checksum in hex>
+  memset(strTmp, 0, 12);
+  nextBuf = QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  if ((uint32_t) strtoul(strTmp, NULL, 10) != fileSize) goto endcmd;
+
+  memset(strTmp, 0, 12);
+  QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  if ((uint16_t) strtoul(strTmp, NULL, 16) != checksum) goto endcmd;
   status = QTEL_OK;
 
   endcmd:
   QTEL_UNLOCK(hqtel);
+  if (isAborted) QTEL_File_Delete(hqtel, storage, filename);
   return status;
 }
 
 
-QTEL_Status_t QTEL_File_Open(QTEL_HandlerTypeDef *hqtel, QTEL_File_t *hfile,
-                             QTEL_File_Storage_t storage, const char *filename)
+/**
+ * whole file is sent in one CONNECT session, the data is passed to sink
+ * through the buffer, size and checksum of +QFDWL are checked at the end
+ */
+QTEL_Status_t QTEL_File_Download(QTEL_HandlerTypeDef *hqtel,
+                                 QTEL_File_Storage_t storage,
+                                 const char *filename,
+                                 uint8_t *buffer,
+                                 uint16_t bufferSize,
+                                 QTEL_File_Sink_Func sink,
+                                 void *ctx)
 {
-  QTEL_Status_t status  = QTEL_ERROR;
-  uint8_t       *resp   = &hqtel->respTmp[0];
-  char          *strTmp = (char*) &hqtel->respTmp[24];
+  QTEL_Status_t status    = QTEL_ERROR;
+  uint8_t       *resp     = &hqtel->respTmp[0];
+  char          *strTmp   = (char*) &hqtel->respTmp[24];
+  const uint8_t *nextBuf;
+  uint32_t      fileSize  = 0;
+  uint32_t      received  = 0;
+  uint16_t      readLen;
+  uint16_t      checksum  = 0;
+
+  if (buffer == NULL || bufferSize == 0) return QTEL_ERROR;
 
   QTEL_LOCK(hqtel);
 
-  hfile->length = 0;
+  // CONNECT has no length, the end of data is known from the file size
+  if (getLength(hqtel, storage, filename, &fileSize) != QTEL_OK) goto endcmd;
 
-  // get file description
   QTEL_SendCMD(hqtel,
-               "AT+QFLST=\"%s%s%s\"",
+               "AT+QFDWL=\"%s%s%s\"",
                StorageStr[storage], (storage>0)?":":"", filename);
 
-  memset(resp, 0, 24);
-  memset(strTmp, 0, 8);
-  status = QTEL_GetResponse(hqtel, "+QFLST", 6, resp, 24, QTEL_GETRESP_WAIT_OK, 5000);
-  if (status == QTEL_OK) {
-    QTEL_ParseStr(resp, ',', 1, (uint8_t*) strTmp);
-    hfile->length = (uint32_t) atoi(strTmp);
+  if (QTEL_GetResponse(hqtel, "CONNECT", 7, NULL, 0, QTEL_GETRESP_ONLY_DATA, 5000) != QTEL_OK)
+    goto endcmd;
+
+  while (received < fileSize) {
+    readLen = (fileSize - received < bufferSize)? (uint16_t) (fileSize - received) : bufferSize;
+    readLen = QTEL_GetData(hqtel, buffer, readLen, 1000);
+    if (readLen == 0) goto endcmd;
+
+    checksum = updateChecksum(checksum, received, buffer, readLen);
+    received += readLen;
+    if (sink != NULL) sink(ctx, buffer, readLen);
   }
 
+  // +QFDWL: <download_size>,<checksum in hex>
+  memset(resp, 0, 24);
+  if (QTEL_GetResponse(hqtel, "+QFDWL", 6, resp, 24, QTEL_GETRESP_WAIT_OK, 5000) != QTEL_OK)
+    goto endcmd;
+
+  memset(strTmp, 0, 12);
+  nextBuf = QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  if ((uint32_t) strtoul(strTmp, NULL, 10) != fileSize) goto endcmd;
+
+  memset(strTmp, 0, 12);
+  QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  if ((uint16_t) strtoul(strTmp, NULL, 16) != checksum) goto endcmd;
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+QTEL_Status_t QTEL_File_Open(QTEL_HandlerTypeDef *hqtel, QTEL_File_t *hfile,
+                             QTEL_File_Storage_t storage, const char *filename)
+{
+  QTEL_Status_t status  = QTEL_ERROR;
+  uint8_t       *resp   = &hqtel->respTmp[0];
+
+  QTEL_LOCK(hqtel);
+
+  // new file isn't listed yet
+  if (getLength(hqtel, storage, filename, &hfile->length) != QTEL_OK)
+    hfile->length = 0;
+
   // open file
   QTEL_SendCMD(hqtel,
                "AT+QFOPEN=\"%s%s%s\",0",
@@ -132,7 +238,8 @@ int32_t QTEL_File_Write(QTEL_File_t *hfile, const uint8_t *srcData, uint16_t dat
   writelen = (uint16_t) atoi(strTmp);
 
   QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*)strTmp);
-  hfile->length = (uint16_t) atoi(strTmp);
+  hfile->length = (uint32_t) atoi(strTmp);
+  hfile->pos += writelen;
 
   status = QTEL_OK;
 
@@ -193,6 +300,27 @@ QTEL_Status_t QTEL_File_Seek(QTEL_File_t *hfile, uint32_t offset)
 }
 
 
+/**
+ * cut the file at current position
+ */
+QTEL_Status_t QTEL_File_Truncate(QTEL_File_t *hfile)
+{
+  QTEL_Status_t status = QTEL_ERROR;
+
+  if (hfile->hqtel == NULL) return status;
+
+  QTEL_LOCK(hfile->hqtel);
+  QTEL_SendCMD(hfile->hqtel, "AT+QFTUCAT=%u", hfile->fileno);
+  if (!QTEL_IsResponseOK(hfile->hqtel)) goto endcmd;
+  hfile->length = hfile->pos;
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hfile->hqtel);
+  return status;
+}
+
+
 QTEL_Status_t QTEL_File_Close(QTEL_File_t *hfile)
 {
   QTEL_Status_t status = QTEL_ERROR;
@@ -223,3 +351,239 @@ QTEL_Status_t QTEL_File_Delete(QTEL_HandlerTypeDef *hqtel, QTEL_File_Storage_t s
   QTEL_UNLOCK(hqtel);
   return status;
 }
+
+
+/**
+ * cache is used as read-ahead and write-behind block,
+ * it must be kept until the file is closed
+ */
+QTEL_Status_t QTEL_BFile_Open(QTEL_HandlerTypeDef *hqtel, QTEL_BFile_t *hbfile,
+                              QTEL_File_Storage_t storage, const char *filename,
+                              uint8_t *cache, uint16_t cacheSize)
+{
+  if (cache == NULL || cacheSize == 0) return QTEL_ERROR;
+
+  hbfile->cache = cache;
+  hbfile->cacheSize = cacheSize;
+  hbfile->cacheLen = 0;
+  hbfile->cachePos = 0;
+  hbfile->isDirty = 0;
+  hbfile->pos = 0;
+  return QTEL_File_Open(hqtel, &hbfile->file, storage, filename);
+}
+
+
+/**
+ * small writes are joined in cache, write not larger than cache
+ * is sent to the modem only when the cache is full, flushed, or
+ * the next write isn't continuing it
+ */
+int32_t QTEL_BFile_Write(QTEL_BFile_t *hbfile, const uint8_t *srcData, uint16_t dataLen)
+{
+  uint16_t  written = 0;
+  uint16_t  copyLen;
+  int32_t   writeLen;
+
+  // read-ahead data may be overwritten
+  if (!hbfile->isDirty) hbfile->cacheLen = 0;
+
+  while (written < dataLen) {
+    if (hbfile->isDirty
+        && (hbfile->pos != hbfile->cachePos + hbfile->cacheLen
+            || hbfile->cacheLen == hbfile->cacheSize))
+    {
+      if (QTEL_BFile_Flush(hbfile) != QTEL_OK) break;
+      hbfile->cacheLen = 0;
+    }
+
+    // nothing to join, write directly
+    if (!hbfile->isDirty && dataLen - written >= hbfile->cacheSize) {
+      if (syncPos(hbfile, hbfile->pos) != QTEL_OK) break;
+      writeLen = QTEL_File_Write(&hbfile->file, &srcData[written], dataLen - written);
+      if (writeLen <= 0) break;
+      written += (uint16_t) writeLen;
+      hbfile->pos += (uint32_t) writeLen;
+      continue;
+    }
+
+    if (!hbfile->isDirty) {
+      hbfile->cachePos = hbfile->pos;
+      hbfile->cacheLen = 0;
+      hbfile->isDirty = 1;
+    }
+    copyLen = hbfile->cacheSize - hbfile->cacheLen;
+    if (copyLen > dataLen - written) copyLen = dataLen - written;
+    memcpy(&hbfile->cache[hbfile->cacheLen], &srcData[written], copyLen);
+    hbfile->cacheLen += copyLen;
+    hbfile->pos += copyLen;
+    written += copyLen;
+  }
+
+  if (written == 0 && dataLen > 0) return -1;
+  return (int32_t) written;
+}
+
+
+/**
+ * read from cache, cache is refilled by one QFREAD of cache size,
+ * read not smaller than cache goes to the buffer directly
+ */
+int32_t QTEL_BFile_Read(QTEL_BFile_t *hbfile, uint8_t *dstBuf, uint16_t bufSz)
+{
+  uint16_t  readLen = 0;
+  uint16_t  copyLen;
+  uint16_t  offset;
+  int32_t   fileReadLen = 0;
+
+  if (hbfile->isDirty && QTEL_BFile_Flush(hbfile) != QTEL_OK) return -1;
+
+  while (readLen < bufSz) {
+    if (hbfile->pos >= hbfile->cachePos && hbfile->pos < hbfile->cachePos + hbfile->cacheLen) {
+      offset = (uint16_t) (hbfile->pos - hbfile->cachePos);
+      copyLen = hbfile->cacheLen - offset;
+      if (copyLen > bufSz - readLen) copyLen = bufSz - readLen;
+      memcpy(&dstBuf[readLen], &hbfile->cache[offset], copyLen);
+      readLen += copyLen;
+      hbfile->pos += copyLen;
+      continue;
+    }
+
+    if (hbfile->pos >= hbfile->file.length) break;
+    if (syncPos(hbfile, hbfile->pos) != QTEL_OK) {
+      fileReadLen = -1;
+      break;
+    }
+
+    if (bufSz - readLen >= hbfile->cacheSize) {
+      fileReadLen = QTEL_File_Read(&hbfile->file, &dstBuf[readLen], bufSz - readLen);
+      if (fileReadLen <= 0) break;
+      readLen += (uint16_t) fileReadLen;
+      hbfile->pos += (uint32_t) fileReadLen;
+      continue;
+    }
+
+    hbfile->cacheLen = 0;
+    fileReadLen = QTEL_File_Read(&hbfile->file, hbfile->cache, hbfile->cacheSize);
+    if (fileReadLen <= 0) break;
+    hbfile->cachePos = hbfile->pos;
+    hbfile->cacheLen = (uint16_t) fileReadLen;
+  }
+
+  if (readLen == 0 && fileReadLen < 0) return -1;
+  return (int32_t) readLen;
+}
+
+
+/**
+ * only the position is changed,
+ * QFSEEK is sent by the next read or write to the modem
+ */
+QTEL_Status_t QTEL_BFile_Seek(QTEL_BFile_t *hbfile, uint32_t offset)
+{
+  hbfile->pos = offset;
+  return QTEL_OK;
+}
+
+
+QTEL_Status_t QTEL_BFile_Flush(QTEL_BFile_t *hbfile)
+{
+  if (!hbfile->isDirty) return QTEL_OK;
+
+  if (syncPos(hbfile, hbfile->cachePos) != QTEL_OK) return QTEL_ERROR;
+  if (QTEL_File_Write(&hbfile->file, hbfile->cache, hbfile->cacheLen) != (int32_t) hbfile->cacheLen)
+    return QTEL_ERROR;
+
+  // written block is still valid for reading
+  hbfile->isDirty = 0;
+  return QTEL_OK;
+}
+
+
+QTEL_Status_t QTEL_BFile_Close(QTEL_BFile_t *hbfile)
+{
+  QTEL_Status_t status = QTEL_BFile_Flush(hbfile);
+
+  if (QTEL_File_Close(&hbfile->file) != QTEL_OK) return QTEL_ERROR;
+  hbfile->cacheLen = 0;
+  hbfile->isDirty = 0;
+  return status;
+}
+
+
+static QTEL_Status_t syncPos(QTEL_BFile_t *hbfile, uint32_t offset)
+{
+  if (hbfile->file.pos == offset) return QTEL_OK;
+  return QTEL_File_Seek(&hbfile->file, offset);
+}
+
+
+/*
+ * must be called while locked
+ */
+static QTEL_Status_t getLength(QTEL_HandlerTypeDef *hqtel, QTEL_File_Storage_t storage,
+                               const char *filename, uint32_t *length)
+{
+  char *resp = (char*) &hqtel->respTmp[0];
+  char *sizeStr;
+
+  QTEL_SendCMD(hqtel,
+               "AT+QFLST=\"%s%s%s\"",
+               StorageStr[storage], (storage>0)?":":"", filename);
+
+  // +QFLST: "<storage>:<filename>",<size>, the name can be up to 80 chars
+  memset(resp, 0, QTEL_TMP_RESP_BUFFER_SIZE);
+  if (QTEL_GetResponse(hqtel, "+QFLST", 6, (uint8_t*) resp, QTEL_TMP_RESP_BUFFER_SIZE-1,
+                       QTEL_GETRESP_WAIT_OK, 5000) != QTEL_OK)
+  {
+    return QTEL_ERROR;
+  }
+
+  sizeStr = strrchr(resp, ',');
+  if (sizeStr == NULL || resp[QTEL_TMP_RESP_BUFFER_SIZE-2] != 0) return QTEL_ERROR;
+  *length = (uint32_t) strtoul(sizeStr+1, NULL, 10);
+  return QTEL_OK;
+}
+
+static const uint8_t *readMemory(void *ctx, uint32_t offset, uint16_t *length)
+{
+  return &((const uint8_t*) ctx)[offset];
+}
+
+
+/*
+ * the modem writes everything it gets into the file until declared size,
+ * so the rest is padded with the acks to get back the command mode,
+ * the incomplete file is deleted after that
+ */
+static void abortUpload(QTEL_HandlerTypeDef *hqtel, uint32_t sent, uint32_t fileSize, uint8_t isWaitAck)
+{
+  uint8_t   *padding = &hqtel->cmdTmp[0];
+  uint16_t  sliceLen;
+
+  memset(padding, 0, sizeof(hqtel->cmdTmp));
+  while (sent < fileSize) {
+    sliceLen = 1024 - (uint16_t) (sent % 1024);
+    if (sliceLen > sizeof(hqtel->cmdTmp)) sliceLen = sizeof(hqtel->cmdTmp);
+    if (sliceLen > fileSize - sent) sliceLen = (uint16_t) (fileSize - sent);
+
+    if (isWaitAck && !QTEL_WaitResponse(hqtel, "A", 1, 5000)) return;
+    if (!QTEL_SendData(hqtel, padding, sliceLen)) return;
+    sent += sliceLen;
+    isWaitAck = (sent % 1024 == 0);
+  }
+  QTEL_GetResponse(hqtel, "+QFUPL", 6, NULL, 0, QTEL_GETRESP_WAIT_OK, 5000);
+}
+
+
+/*
+ * XOR of 16-bit big-endian words, odd byte is padded by zero
+ */
+static uint16_t updateChecksum(uint16_t checksum, uint32_t offset, const uint8_t *data, uint16_t length)
+{
+  while (length--) {
+    checksum ^= (offset & 1)? (uint16_t) *data : (uint16_t) (*data << 8);
+    data++;
+    offset++;
+  }
+  return checksum;
+}
@@ -14,6 +14,7 @@
 #include "../include/quectel/utils.h"
 #include "../include/quectel/debug.h"
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <buffer.h>
 
@@ -42,8 +43,34 @@ static char* keyStr[QTEL_GPS_CFG_KEYS_NUM] = {
   "fixfreq",
 };
 
+/**
+ * copy of the last fix without locking, it can be called from any task or ISR.
+ * the fix is written once per epoch, a read is repeated only when
+ * the writer has replaced both slots meanwhile
+ */
+QTEL_Status_t QTEL_GPS_GetFix(QTEL_HandlerTypeDef *hqtel, QTEL_GPS_Fix_t *fix)
+{
+  uint32_t seq;
+
+  do {
+    seq = hqtel->gps.fixSeq;
+    if (seq < 2) return QTEL_ERROR;
+    QTEL_MemoryBarrier();
+    memcpy(fix, &hqtel->gps.fix[(seq >> 1) & 1], sizeof(QTEL_GPS_Fix_t));
+    QTEL_MemoryBarrier();
+  } while ((uint32_t) (hqtel->gps.fixSeq - (seq & ~1UL)) > 2);
+
+  fix->age = QTEL_GetTick() - fix->tick;
+  return QTEL_OK;
+}
+
+
 static QTEL_Status_t setGPSDefaultConfiguration(QTEL_HandlerTypeDef*);
 static void gpsProcessBuffer(QTEL_HandlerTypeDef*);
+static void gpsReadNMEAPort(QTEL_HandlerTypeDef*);
+static uint8_t parseLocation(const char *str, QTEL_GPS_Fix_t*);
+static void fixFromNMEA(QTEL_HandlerTypeDef*, QTEL_GPS_Fix_t*);
+static void publishFix(QTEL_HandlerTypeDef*, const QTEL_GPS_Fix_t*);
 static void writeXTraFile(QTEL_HandlerTypeDef*,
                           const uint8_t *data, uint16_t dataLen, uint32_t maxDataLen);
 
@@ -77,7 +104,12 @@ void QTEL_GPS_HandleEvents(QTEL_HandlerTypeDef *hqtel)
     }
   }
 
-  if (QTEL_GPS_IS_STATUS(hqtel, QTEL_GPS_STATUS_ACTIVE) && QTEL_IsTimeout(hqtel->gps.nmeaTick, 5000)) {
+  if (QTEL_GPS_IS_STATUS(hqtel, QTEL_GPS_STATUS_ACTIVE)
+      && hqtel->gps.nmeaSerial.device != NULL && hqtel->gps.nmeaSerial.read != NULL)
+  {
+    gpsReadNMEAPort(hqtel);
+  }
+  else if (QTEL_GPS_IS_STATUS(hqtel, QTEL_GPS_STATUS_ACTIVE) && QTEL_IsTimeout(hqtel->gps.nmeaTick, 5000)) {
     hqtel->gps.nmeaTick = QTEL_GetTick();
     QTEL_GPS_getLocation(hqtel);
     QTEL_GPS_AcquireNMEA(hqtel, "GGA");
@@ -131,6 +163,8 @@ void QTEL_GPS_Init(QTEL_HandlerTypeDef *hqtel, uint8_t *buffer, uint16_t bufferS
   hqtel->gps.buffer.buffer = buffer;
   hqtel->gps.buffer.size = bufferSize;
   lwgps_init(&hqtel->gps.lwgps);
+  memset(hqtel->gps.fix, 0, sizeof(hqtel->gps.fix));
+  hqtel->gps.fixSeq = 0;
 }
 
 
@@ -175,7 +209,8 @@ QTEL_Status_t QTEL_GPS_Deactivate(QTEL_HandlerTypeDef *hqtel)
 QTEL_Status_t QTEL_GPS_SetupOneXTra(QTEL_HandlerTypeDef *hqtel)
 {
   QTEL_Status_t status;
-  QTEL_File_t   xtraFile;
+  QTEL_BFile_t  xtraFile;
+  uint8_t       xtraCache[QTEL_FILE_BLOCK_SIZE];
   char          *xtraFilename   = "xtra2.bin";
   QTEL_Datetime dt;
   uint16_t      durtime = 0;
@@ -204,7 +239,8 @@ QTEL_Status_t QTEL_GPS_SetupOneXTra(QTEL_HandlerTypeDef *hqtel)
   QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, xtraFilename);
 
   // create file
-  status = QTEL_File_Open(hqtel, &xtraFile, QTEL_File_Storage_UFS, xtraFilename);
+  status = QTEL_BFile_Open(hqtel, &xtraFile, QTEL_File_Storage_UFS, xtraFilename,
+                           xtraCache, sizeof(xtraCache));
   if (status != QTEL_OK) return status;
 
   hqtel->gps.xtraFileTmpPtr = &xtraFile;
@@ -214,7 +250,7 @@ QTEL_Status_t QTEL_GPS_SetupOneXTra(QTEL_HandlerTypeDef *hqtel)
                                writeXTraFile, hqtel->gps.buffer.buffer, hqtel->gps.buffer.size, 10000);
     if (status == QTEL_OK) break;
   }
-  status = QTEL_File_Close(&xtraFile);
+  status = QTEL_BFile_Close(&xtraFile);
   hqtel->gps.xtraFileTmpPtr = 0;
   if (status != QTEL_OK) return status;
 
@@ -265,17 +301,24 @@ QTEL_Status_t QTEL_GPS_DeleteOneXTra(QTEL_HandlerTypeDef *hqtel)
 }
 
 
+/**
+ * query the position and put it into the fix cache
+ */
 QTEL_Status_t QTEL_GPS_getLocation(QTEL_HandlerTypeDef *hqtel)
 {
-  QTEL_Status_t status  = QTEL_ERROR;
-  uint8_t       *resp   = &hqtel->respTmp[0];
+  QTEL_Status_t   status  = QTEL_ERROR;
+  uint8_t         *resp   = &hqtel->respTmp[0];
+  QTEL_GPS_Fix_t  fix;
 
   QTEL_LOCK(hqtel);
-  memset(resp, 0, 64);
+  memset(resp, 0, QTEL_TMP_RESP_BUFFER_SIZE);
 
   QTEL_SendCMD(hqtel, "AT+QGPSLOC=2");
-  if (QTEL_GetResponse(hqtel, "+QGPSLOC", 8, resp, 64, QTEL_GETRESP_WAIT_OK, 2000) != QTEL_OK)
+  if (QTEL_GetResponse(hqtel, "+QGPSLOC", 8, resp, QTEL_TMP_RESP_BUFFER_SIZE-1,
+                       QTEL_GETRESP_WAIT_OK, 2000) != QTEL_OK)
     goto endcmd;
+  if (!parseLocation((char*) resp, &fix)) goto endcmd;
+  publishFix(hqtel, &fix);
   status = QTEL_OK;
 
   endcmd:
@@ -304,8 +347,8 @@ static QTEL_Status_t setGPSDefaultConfiguration(QTEL_HandlerTypeDef *hqtel)
   QTEL_Status_t status  = QTEL_ERROR;
 
   // values
-  char      *outPort          = "usbnmea";
-  uint8_t   nmeaSrc           = 1;
+  char      *outPort          = QTEL_GPS_NMEA_PORT;
+  uint8_t   nmeaSrc           = (hqtel->gps.nmeaSerial.device == NULL)? 1 : 0;  // AT+QGPSGNMEA
   uint8_t   gpsNMEAType       = 0x1F;
   uint8_t   glonassNMEAType   = 0;
   uint8_t   galileoNMEAType   = 0;
@@ -319,7 +362,7 @@ static QTEL_Status_t setGPSDefaultConfiguration(QTEL_HandlerTypeDef *hqtel)
   uint8_t   suplVer           = 2;
   uint32_t  agpsPosmode       = 0x01FEFF7F;
   uint16_t  agnssProtocol[2]  = {0x03, 0x0507};
-  uint8_t   fixFreq           = 1;
+  uint8_t   fixFreq           = QTEL_GPS_FIX_FREQ;
 
 
   QTEL_GPS_Config(hqtel, QTEL_GPS_CFG_OutPort, outPort);
@@ -365,12 +408,127 @@ static void gpsProcessBuffer(QTEL_HandlerTypeDef *hqtel)
 }
 
 
+/*
+ * sentences come at fix rate without any command on AT port
+ */
+static void gpsReadNMEAPort(QTEL_HandlerTypeDef *hqtel)
+{
+  void            *device = hqtel->gps.nmeaSerial.device;
+  uint16_t        readLen;
+  uint8_t         isRead  = 0;
+  QTEL_GPS_Fix_t  fix;
+
+  while (hqtel->gps.nmeaSerial.isAvailable == NULL || hqtel->gps.nmeaSerial.isAvailable(device)) {
+    readLen = hqtel->gps.nmeaSerial.read(device, &hqtel->gps.readBuffer[0], QTEL_GPS_TMP_BUF_SIZE, 0);
+    if (readLen == 0) break;
+    isRead = 1;
+    hqtel->gps.nmeaTick = QTEL_GetTick();
+    lwgps_process(&hqtel->gps.lwgps, &hqtel->gps.readBuffer[0], readLen);
+  }
+  if (!isRead) return;
+
+  // each epoch changes at least the time, so unchanged sentences aren't published again
+  fixFromNMEA(hqtel, &fix);
+  if (hqtel->gps.fixSeq >= 2
+      && memcmp(&fix, &hqtel->gps.fix[(hqtel->gps.fixSeq >> 1) & 1], offsetof(QTEL_GPS_Fix_t, seq)) == 0)
+  {
+    return;
+  }
+  QTEL_LOCK(hqtel);
+  publishFix(hqtel, &fix);
+  QTEL_UNLOCK(hqtel);
+}
+
+
+/*
+ * +QGPSLOC: <UTC>,<latitude>,<longitude>,<hdop>,<altitude>,<fix>,<cog>,<spkm>,<spkn>,<date>,<nsat>
+ * UTC is hhmmss.sss, cog is ddd.mm and date is ddmmyy
+ */
+static uint8_t parseLocation(const char *str, QTEL_GPS_Fix_t *fix)
+{
+  double    values[11];
+  char      *end;
+  uint32_t  hhmmss, ddmmyy;
+  uint8_t   i;
+
+  for (i = 0; i < 11; i++) {
+    values[i] = strtod(str, &end);
+    if (end == str || (i < 10 && *end != ',')) return 0;
+    str = end + 1;
+  }
+
+  memset(fix, 0, sizeof(QTEL_GPS_Fix_t));
+  hhmmss = (uint32_t) values[0];
+  ddmmyy = (uint32_t) values[9];
+  fix->time.hour    = (uint8_t) (hhmmss / 10000);
+  fix->time.minute  = (uint8_t) (hhmmss / 100 % 100);
+  fix->time.second  = (uint8_t) (hhmmss % 100);
+  fix->time.day     = (uint8_t) (ddmmyy / 10000);
+  fix->time.month   = (uint8_t) (ddmmyy / 100 % 100);
+  fix->time.year    = (uint8_t) (ddmmyy % 100);
+  fix->latitude     = values[1];
+  fix->longitude    = values[2];
+  fix->hdop         = (float) values[3];
+  fix->altitude     = (float) values[4];
+  fix->fixType      = (values[5] == 3)? QTEL_GPS_FIX_3D : QTEL_GPS_FIX_2D;
+  fix->course       = (float) ((uint16_t) values[6] + (values[6] - (uint16_t) values[6]) * 100 / 60);
+  fix->speed        = (float) values[7];
+  fix->satellites   = (uint8_t) values[10];
+  return 1;
+}
+
+
+static void fixFromNMEA(QTEL_HandlerTypeDef *hqtel, QTEL_GPS_Fix_t *fix)
+{
+  lwgps_t *gps = &hqtel->gps.lwgps;
+
+  memset(fix, 0, sizeof(QTEL_GPS_Fix_t));
+  fix->time.hour    = gps->hours;
+  fix->time.minute  = gps->minutes;
+  fix->time.second  = gps->seconds;
+  fix->time.day     = gps->date;
+  fix->time.month   = gps->month;
+  fix->time.year    = gps->year;
+  fix->latitude     = gps->latitude;
+  fix->longitude    = gps->longitude;
+  fix->altitude     = (float) gps->altitude;
+  fix->speed        = (float) (gps->speed * 1.852);   // knots
+  fix->course       = (float) gps->course;
+  fix->hdop         = (float) gps->dop_h;
+  fix->satellites   = gps->sats_in_use;
+
+  if (!gps->is_valid && gps->fix == 0)  fix->fixType = QTEL_GPS_FIX_NONE;
+  else if (gps->fix_mode == 3)          fix->fixType = QTEL_GPS_FIX_3D;
+  else                                  fix->fixType = QTEL_GPS_FIX_2D;
+}
+
+
+/*
+ * the unpublished slot is written while fixSeq is odd,
+ * readers keep reading the other one
+ */
+static void publishFix(QTEL_HandlerTypeDef *hqtel, const QTEL_GPS_Fix_t *fix)
+{
+  uint32_t        seq   = hqtel->gps.fixSeq;
+  QTEL_GPS_Fix_t  *slot = &hqtel->gps.fix[((seq >> 1) + 1) & 1];
+
+  hqtel->gps.fixSeq = seq + 1;
+  QTEL_MemoryBarrier();
+  memcpy(slot, fix, offsetof(QTEL_GPS_Fix_t, seq));
+  slot->seq = (seq >> 1) + 1;
+  slot->tick = QTEL_GetTick();
+  slot->age = 0;
+  QTEL_MemoryBarrier();
+  hqtel->gps.fixSeq = seq + 2;
+}
+
+
 static void writeXTraFile(QTEL_HandlerTypeDef *hqtel, const uint8_t *data, uint16_t dataLen, uint32_t maxDataLen)
 {
-  QTEL_File_t *xtraFilePtr = (QTEL_File_t*)hqtel->gps.xtraFileTmpPtr;
+  QTEL_BFile_t *xtraFilePtr = (QTEL_BFile_t*)hqtel->gps.xtraFileTmpPtr;
   if (xtraFilePtr == NULL) return;
 
-  QTEL_File_Write(xtraFilePtr, data, dataLen);
+  QTEL_BFile_Write(xtraFilePtr, data, dataLen);
 }
 
 #endif /* QTEL_EN_FEATURE_GPS */
@@ -18,6 +18,18 @@
 
 #define TMP_FILE_FORMAT "tmp%u.http"
 
+// state of chunked decoder
+#define CHUNK_SIZE      0
+#define CHUNK_EXT       1
+#define CHUNK_DATA      2
+#define CHUNK_DATA_END  3
+#define CHUNK_TRAILER   4
+#define CHUNK_DONE      5
+
+// written by the modem after the content of AT+QHTTPREAD
+#define READ_TRAILER      "\r\nOK\r\n\r\n+QHTTPREAD: "
+#define READ_TRAILER_LEN  (sizeof(READ_TRAILER) - 1)
+
 
 static char* keyStr[QTEL_HTTP_CFG_KEYS_NUM] = {
   "contextid",
@@ -34,19 +46,150 @@ static char* keyStr[QTEL_HTTP_CFG_KEYS_NUM] = {
 };
 
 static QTEL_Status_t setDefaultConfig(QTEL_HandlerTypeDef*);
-static uint16_t parseHeader(uint8_t *srcbuf, uint16_t bufLen, uint8_t *isHeaderClosed);
+static void          beginResponse(QTEL_HandlerTypeDef*);
+static void          readResponse(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*, const uint8_t *data, uint16_t dataLen);
+static uint8_t       isResponseEnd(QTEL_HandlerTypeDef*);
+static uint16_t      parseHeader(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*, const uint8_t *data, uint16_t dataLen);
+static void          parseHeaderLine(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static void          decodeContent(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*, const uint8_t *data, uint16_t dataLen);
+static void          copyHeaderValue(char *dst, uint16_t dstSize, const char *value, uint16_t valueLen);
+static void          beginContent(QTEL_HandlerTypeDef*);
+static void          passContent(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*, const uint8_t *data, uint16_t dataLen);
+static QTEL_Status_t endContent(QTEL_HandlerTypeDef*);
+#if QTEL_EN_FEATURE_INFLATE
+static void          writeInflated(void *ctx, const uint8_t *data, uint16_t length);
+#endif
+static QTEL_Status_t prepareRequest(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static void          finishRequest(QTEL_HandlerTypeDef*, uint8_t isError);
+static uint32_t      hashStr(const char *str, uint16_t len);
+static QTEL_Status_t sendRequest(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static QTEL_Status_t startRequest(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static const char*   getRespCode(QTEL_HTTP_Request_t*);
+static QTEL_Status_t parseResult(QTEL_HandlerTypeDef*, const uint8_t *resp);
+static QTEL_Status_t sendBody(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static uint16_t      getInputTime(QTEL_HTTP_Request_t*);
+static void          abortBody(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static QTEL_Status_t sendRequestHeader(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static QTEL_Status_t readStream(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static QTEL_Status_t readUntilTrailer(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*);
+static uint16_t      putContent(QTEL_HandlerTypeDef*, QTEL_HTTP_Request_t*, uint16_t bufLen,
+                                const uint8_t *data, uint16_t dataLen);
+static void          startAsync(QTEL_HandlerTypeDef*, QTEL_HTTP_Async_t*);
+static void          readAsyncFile(QTEL_HandlerTypeDef*, QTEL_HTTP_Async_t*);
+static void          readAsyncContent(QTEL_HandlerTypeDef*, QTEL_HTTP_Async_t*);
+static void          completeAsync(QTEL_HandlerTypeDef*, QTEL_HTTP_Async_t*, QTEL_Status_t);
 
 
+/*
+ * result of request in the queue,
+ * +QHTTP<method>: <err>[,<httprspcode>[,<content_length>]]
+ * +QHTTPREADFILE: <err>
+ */
 uint8_t QTEL_HTTP_CheckAsyncResponse(QTEL_HandlerTypeDef *hqtel)
 {
-  uint8_t         isGet   = 0;
+  uint8_t           isGet   = 0;
+  QTEL_HTTP_Async_t *async  = QTEL_HTTP_GetActive(hqtel);
+  const char        *respCode;
+  uint8_t           respCodeLen;
+
+  if (async == NULL) return isGet;
+
+  if (async->state == QTEL_HTTP_ASYNC_WAIT_RESP) {
+    respCode = getRespCode(&async->request);
+    respCodeLen = strlen(respCode);
+    if ((isGet = (hqtel->respBufferLen > respCodeLen+2
+                  && QTEL_IsResponse(hqtel, respCode, respCodeLen)
+                  && hqtel->respBuffer[respCodeLen] == ':')))
+    {
+      if (parseResult(hqtel, &hqtel->respBuffer[respCodeLen+2]) == QTEL_OK)
+        async->state = QTEL_HTTP_ASYNC_RESPONDED;
+      else
+        async->state = QTEL_HTTP_ASYNC_FAILED;
+    }
+  }
+
+  else if (async->state == QTEL_HTTP_ASYNC_WAIT_FILE) {
+    if ((isGet = (hqtel->respBufferLen > 16 && QTEL_IsResponse(hqtel, "+QHTTPREADFILE: ", 16)))) {
+      hqtel->HTTP.response.error = (uint16_t) atoi((char*) &hqtel->respBuffer[16]);
+      if (hqtel->HTTP.response.error == 0)
+        async->state = QTEL_HTTP_ASYNC_FILE_READY;
+      else
+        async->state = QTEL_HTTP_ASYNC_FAILED;
+    }
+  }
 
   return isGet;
 }
 
 
+/*
+ * run the queue step by step, so other modules keep being handled
+ * while the request is in progress
+ */
 void QTEL_HTTP_HandleEvents(QTEL_HandlerTypeDef *hqtel)
 {
+  QTEL_HTTP_Async_t *async = QTEL_HTTP_GetActive(hqtel);
+
+  if (async == NULL) return;
+
+  switch (async->state) {
+  case QTEL_HTTP_ASYNC_QUEUED:
+    // wait for blocking request
+    if (QTEL_HTTP_IS_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING)) break;
+    if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) break;
+    startAsync(hqtel, async);
+    break;
+
+  case QTEL_HTTP_ASYNC_WAIT_RESP:
+    if (QTEL_IsTimeout(async->tick, async->request.timeout + 5000))
+      completeAsync(hqtel, async, QTEL_TIMEOUT);
+    break;
+
+  case QTEL_HTTP_ASYNC_RESPONDED:
+    readAsyncFile(hqtel, async);
+    break;
+
+  case QTEL_HTTP_ASYNC_WAIT_FILE:
+    if (QTEL_IsTimeout(async->tick, 65000))
+      completeAsync(hqtel, async, QTEL_TIMEOUT);
+    break;
+
+  case QTEL_HTTP_ASYNC_FILE_READY:
+    if (QTEL_File_Open(hqtel, &async->file, QTEL_File_Storage_RAM, async->filename) != QTEL_OK) {
+      completeAsync(hqtel, async, QTEL_ERROR);
+      break;
+    }
+    beginResponse(hqtel);
+    async->state = QTEL_HTTP_ASYNC_READ_HEADER;
+    break;
+
+  case QTEL_HTTP_ASYNC_READ_HEADER:
+  case QTEL_HTTP_ASYNC_READ_CONTENT:
+    readAsyncContent(hqtel, async);
+    break;
+
+  default:
+    completeAsync(hqtel, async, QTEL_ERROR);
+    break;
+  }
+}
+
+
+/*
+ * configuration and URL in the modem are lost after restarting
+ */
+void QTEL_HTTP_OnStarted(QTEL_HandlerTypeDef *hqtel)
+{
+  QTEL_HTTP_Async_t *async = QTEL_HTTP_GetActive(hqtel);
+
+  hqtel->HTTP.session.isConfigured = 0;
+  hqtel->HTTP.session.contentType = -1;
+  hqtel->HTTP.session.urlLen = 0;
+  hqtel->HTTP.customHeaderHash = hashStr("", 0);
+  hqtel->HTTP.isReqHeader = 0;
+
+  if (async != NULL && async->state != QTEL_HTTP_ASYNC_QUEUED)
+    async->state = QTEL_HTTP_ASYNC_FAILED;
 }
 
 
@@ -75,75 +218,114 @@ QTEL_Status_t QTEL_HTTP_Config(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_ConfigKey_t
 }
 
 
+void QTEL_HTTP_SetReadMode(QTEL_HandlerTypeDef *hqtel, uint8_t readMode)
+{
+  hqtel->HTTP.readMode = readMode;
+}
+
+
+#if QTEL_EN_FEATURE_INFLATE
+/**
+ * request compressed content and decompress it before the content reader,
+ * maxLen of the reader is 0 for decompressed content. NULL to disable
+ */
+void QTEL_HTTP_SetInflater(QTEL_HandlerTypeDef *hqtel, QTEL_Inflate_t *inflater)
+{
+  hqtel->HTTP.inflater = inflater;
+}
+#endif
+
+
 QTEL_Status_t QTEL_HTTP_Request(QTEL_HandlerTypeDef *hqtel,
                                 QTEL_HTTP_Method_t method, const char *url,
                                 QTEL_HTTP_ContentReader_Func cb,
                                 uint8_t *contentBuf, uint16_t contentBufLen,
                                 uint32_t timeout)
+{
+  QTEL_HTTP_Request_t req;
+
+  memset(&req, 0, sizeof(QTEL_HTTP_Request_t));
+  req.method = method;
+  req.url = url;
+  req.timeout = timeout;
+  req.onContent = cb;
+  req.contentBuf = contentBuf;
+  req.contentBufLen = contentBufLen;
+
+  return QTEL_HTTP_Send(hqtel, &req);
+}
+
+
+QTEL_Status_t QTEL_HTTP_Post(QTEL_HandlerTypeDef *hqtel, const char *url,
+                             const uint8_t *body, uint32_t bodyLen,
+                             QTEL_HTTP_ContentReader_Func cb,
+                             uint8_t *contentBuf, uint16_t contentBufLen,
+                             uint32_t timeout)
+{
+  QTEL_HTTP_Request_t req;
+
+  memset(&req, 0, sizeof(QTEL_HTTP_Request_t));
+  req.method = QTEL_HTTP_POST;
+  req.url = url;
+  req.timeout = timeout;
+  req.body.contentType = QTEL_HTTP_CONTENT_OCTET_STREAM;
+  req.body.data = body;
+  req.body.length = bodyLen;
+  req.onContent = cb;
+  req.contentBuf = contentBuf;
+  req.contentBufLen = contentBufLen;
+
+  return QTEL_HTTP_Send(hqtel, &req);
+}
+
+
+QTEL_Status_t QTEL_HTTP_Send(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
 {
   QTEL_Status_t status  = QTEL_ERROR;
-  uint16_t      urlLen  = strlen(url);
   uint32_t      tick    = QTEL_GetTick();
   QTEL_File_t   f_content;
-  uint32_t      readlen;
-  uint16_t      tmpReadlen;
-  uint8_t       isHeaderClosed;
+  int32_t       readlen;
   char          *tmpFilename  = (char*) &hqtel->cmdTmp[0];
   uint8_t       *resp         = &hqtel->respTmp[0];
   char          *strTmp       = (char*) &hqtel->respTmp[24];
   const uint8_t *nextBuf;
+  uint8_t       *contentBuf   = req->contentBuf;
+  uint16_t      contentBufLen = req->contentBufLen;
 
   while (QTEL_HTTP_IS_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING)) {
-    if (QTEL_IsTimeout(tick, timeout)) return QTEL_TIMEOUT;
+    if (QTEL_IsTimeout(tick, req->timeout)) return QTEL_TIMEOUT;
     QTEL_Delay(1);
   }
   QTEL_HTTP_SET_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING);
 
-  hqtel->HTTP.lastUrl = url;
+  hqtel->HTTP.lastUrl = req->url;
   hqtel->HTTP.response.error = 0;
   hqtel->HTTP.response.code = 0;
   hqtel->HTTP.response.contentLen = 0;
-  QTEL_HTTP_Stop(hqtel);
-  setDefaultConfig(hqtel);
-  QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_CtxId, &hqtel->net.contextId);
-
-  QTEL_LOCK(hqtel);
 
-  // input url
-  QTEL_SendCMD(hqtel, "AT+QHTTPURL=%u,1000", urlLen);
-  status = QTEL_GetResponse(hqtel, "CONNECT", 7, NULL, 0, QTEL_GETRESP_ONLY_DATA, 0);
-  if (status != QTEL_OK)
-    goto handleError;
+  status = prepareRequest(hqtel, req);
+  if (status != QTEL_OK) {
+    finishRequest(hqtel, 1);
+    return status;
+  }
 
-  QTEL_SendData(hqtel, (uint8_t*)url, urlLen);
-  if (!QTEL_IsResponseOK(hqtel)) goto handleError;
+  QTEL_LOCK(hqtel);
 
   // request
-  QTEL_SendCMD(hqtel, "AT+QHTTPGET=%d", (timeout/1000));
-  if (!QTEL_IsResponseOK(hqtel)) goto handleError;
-
-  // wait response
-  memset(resp, 0, 24);
-  status = QTEL_GetResponse(hqtel, "+QHTTPGET", 9, resp, 24, QTEL_GETRESP_ONLY_DATA, timeout);
+  status = sendRequest(hqtel, req);
   if (status != QTEL_OK) goto handleError;
+  QTEL_BITS_SET(hqtel->HTTP.events, QTEL_HTTP_EVENT_GET_RESP);
 
-  memset(strTmp, 0, 4);
-  nextBuf = QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
-  hqtel->HTTP.response.error = (uint16_t) atoi(strTmp);
-  if (hqtel->HTTP.response.error != 0) {
-    status = QTEL_ERROR;
-    goto handleError;
+  if (hqtel->HTTP.readMode == QTEL_HTTP_READ_STREAM) {
+    if (contentBuf != NULL) {
+      status = readStream(hqtel, req);
+      if (status != QTEL_OK) goto handleError;
+    }
+    QTEL_UNLOCK(hqtel);
+    finishRequest(hqtel, 0);
+    return QTEL_OK;
   }
 
-  memset(strTmp, 0, 4);
-  nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
-  hqtel->HTTP.response.code = (uint16_t) atoi(strTmp);
-
-  memset(strTmp, 0, 8);
-  QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
-  hqtel->HTTP.response.contentLen = (uint32_t) atoi(strTmp);
-  QTEL_BITS_SET(hqtel->HTTP.events, QTEL_HTTP_EVENT_GET_RESP);
-
   // save file in temporary
   hqtel->HTTP.counterIdTmpFile++;
   sprintf(tmpFilename, TMP_FILE_FORMAT, hqtel->HTTP.counterIdTmpFile);
@@ -164,49 +346,96 @@ QTEL_Status_t QTEL_HTTP_Request(QTEL_HandlerTypeDef *hqtel,
   }
 
   QTEL_UNLOCK(hqtel);
-  QTEL_HTTP_Stop(hqtel);
-  QTEL_HTTP_UNSET_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING);
+  finishRequest(hqtel, 0);
 
   // readfile
   if (contentBuf != NULL) {
     status = QTEL_File_Open(hqtel, &f_content, QTEL_File_Storage_RAM, tmpFilename);
-    if (status != QTEL_OK) goto handleError;
-
-    // read header
-    readlen = 0;
-    do {
-      QTEL_Delay(10);
-      tmpReadlen = QTEL_File_Read(&f_content, contentBuf, contentBufLen);
-      if (tmpReadlen == 0) break;
-      readlen += (uint32_t) parseHeader(contentBuf, tmpReadlen, &isHeaderClosed);
-      QTEL_File_Seek(&f_content, readlen);
-      if (isHeaderClosed) {
-        break;
-      }
-    } while(1);
-
-    // read content
-    readlen = 0;
-    do {
-      tmpReadlen = QTEL_File_Read(&f_content, contentBuf, contentBufLen);
-      if (tmpReadlen == 0) break;
-      readlen += (uint32_t)tmpReadlen;
-      if (cb != NULL) cb(hqtel, contentBuf, tmpReadlen, hqtel->HTTP.response.contentLen);
-    } while(readlen < hqtel->HTTP.response.contentLen);
+    if (status != QTEL_OK) {
+      QTEL_File_Delete(hqtel, QTEL_File_Storage_RAM, tmpFilename);
+      return status;
+    }
+
+    // header and content are read in one pass
+    beginResponse(hqtel);
+    while ((readlen = QTEL_File_Read(&f_content, contentBuf, contentBufLen)) > 0) {
+      readResponse(hqtel, req, contentBuf, (uint16_t) readlen);
+      if (isResponseEnd(hqtel)) break;
+    }
     QTEL_File_Close(&f_content);
+    status = endContent(hqtel);
   }
   QTEL_File_Delete(hqtel, QTEL_File_Storage_RAM, tmpFilename);
 
-  return QTEL_OK;
+  return status;
 
   handleError:
   QTEL_UNLOCK(hqtel);
-  QTEL_HTTP_Stop(hqtel);
-  QTEL_HTTP_UNSET_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING);
+  finishRequest(hqtel, 1);
   return status;
 }
 
 
+/**
+ * add request to the queue without blocking,
+ * onComplete is called from QTEL_HTTP_HandleEvents.
+ * blocking request from the same loop must not be used while the queue is running
+ */
+QTEL_Status_t QTEL_HTTP_Submit(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Async_t *async)
+{
+  uint8_t idx;
+
+  if (async->request.url == NULL) return QTEL_ERROR;
+  if (hqtel->HTTP.queue.count >= QTEL_HTTP_QUEUE_SIZE) return QTEL_BUSY;
+
+  async->status = QTEL_ERROR;
+  async->error = 0;
+  async->code = 0;
+  async->contentLen = 0;
+  async->filename[0] = 0;
+  async->state = QTEL_HTTP_ASYNC_QUEUED;
+
+  idx = (hqtel->HTTP.queue.head + hqtel->HTTP.queue.count) % QTEL_HTTP_QUEUE_SIZE;
+  hqtel->HTTP.queue.items[idx] = async;
+  hqtel->HTTP.queue.count++;
+  return QTEL_OK;
+}
+
+
+/**
+ * request of the queue which is in progress or to be started
+ */
+QTEL_HTTP_Async_t* QTEL_HTTP_GetActive(QTEL_HandlerTypeDef *hqtel)
+{
+  if (hqtel->HTTP.queue.count == 0) return NULL;
+  return (QTEL_HTTP_Async_t*) hqtel->HTTP.queue.items[hqtel->HTTP.queue.head];
+}
+
+
+/**
+ * value of "<name>: <value>" line, name must be in lower case
+ */
+const char* QTEL_HTTP_GetHeaderValue(const char *line, uint16_t lineLen, const char *name, uint16_t *valueLen)
+{
+  uint16_t i = 0;
+  char     c;
+
+  while (*name != 0) {
+    if (i >= lineLen) return NULL;
+    c = line[i++];
+    if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+    if (c != *name++) return NULL;
+  }
+  if (i >= lineLen || line[i++] != ':') return NULL;
+
+  while (i < lineLen && (line[i] == ' ' || line[i] == '\t')) i++;
+  while (lineLen > i && (line[lineLen-1] == ' ' || line[lineLen-1] == '\t')) lineLen--;
+
+  *valueLen = lineLen - i;
+  return &line[i];
+}
+
+
 QTEL_Status_t QTEL_HTTP_Stop(QTEL_HandlerTypeDef *hqtel)
 {
   QTEL_Status_t status = QTEL_ERROR;
@@ -223,6 +452,138 @@ QTEL_Status_t QTEL_HTTP_Stop(QTEL_HandlerTypeDef *hqtel)
 }
 
 
+/**
+ * keep configuration, URL and connection in the modem between requests,
+ * closeWaitTime (s) holds the connection open for the next request
+ */
+QTEL_Status_t QTEL_HTTP_BeginSession(QTEL_HandlerTypeDef *hqtel, uint16_t closeWaitTime)
+{
+  int value = closeWaitTime;
+
+  hqtel->HTTP.session.isActive = 1;
+  if (closeWaitTime == 0) return QTEL_OK;
+  return QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_CloseWaitTime, &value);
+}
+
+
+void QTEL_HTTP_EndSession(QTEL_HandlerTypeDef *hqtel)
+{
+  hqtel->HTTP.session.isActive = 0;
+  QTEL_HTTP_Stop(hqtel);
+}
+
+
+/*
+ * apply configuration and URL which are not in the modem yet
+ */
+static QTEL_Status_t prepareRequest(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  QTEL_Status_t status;
+  uint16_t      urlLen = strlen(req->url);
+  uint32_t      urlHash = hashStr(req->url, urlLen);
+  int           contentType;
+  const char    *customHeader;
+  uint32_t      headerHash;
+  int           isReqHeader;
+
+  if (!hqtel->HTTP.session.isActive || !hqtel->HTTP.session.isConfigured) {
+    QTEL_HTTP_Stop(hqtel);
+    setDefaultConfig(hqtel);
+    QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_CtxId, &hqtel->net.contextId);
+    hqtel->HTTP.session.isConfigured = hqtel->HTTP.session.isActive;
+    hqtel->HTTP.session.contentType = -1;
+    hqtel->HTTP.session.urlLen = 0;
+  }
+
+  // configuration stays in the modem, so it is sent only when it changes
+  customHeader = req->customHeader;
+#if QTEL_EN_FEATURE_INFLATE
+  if (customHeader == NULL && hqtel->HTTP.inflater != NULL) customHeader = "Accept-Encoding: gzip, deflate";
+#endif
+  if (customHeader == NULL) customHeader = "";
+
+  // quotes can't be in AT string, ex: ETag of If-None-Match,
+  // so such header of GET is sent with the whole request header
+  isReqHeader = (req->method == QTEL_HTTP_GET && strchr(customHeader, '\"') != NULL);
+  if (hqtel->HTTP.isReqHeader != isReqHeader) {
+    if (QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_ReqHeader, &isReqHeader) != QTEL_OK)
+      return QTEL_ERROR;
+    hqtel->HTTP.isReqHeader = (uint8_t) isReqHeader;
+  }
+
+  headerHash = hashStr(customHeader, strlen(customHeader));
+  if (!isReqHeader && hqtel->HTTP.customHeaderHash != headerHash) {
+    if (QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_CustomHeader, (void*) customHeader) != QTEL_OK)
+      return QTEL_ERROR;
+    hqtel->HTTP.customHeaderHash = headerHash;
+  }
+
+  if (req->method == QTEL_HTTP_POST && hqtel->HTTP.session.contentType != req->body.contentType) {
+    contentType = req->body.contentType;
+    if (QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_ContentType, &contentType) != QTEL_OK)
+      return QTEL_ERROR;
+    if (hqtel->HTTP.session.isActive) hqtel->HTTP.session.contentType = (int8_t) contentType;
+  }
+
+  if (hqtel->HTTP.session.isActive
+      && hqtel->HTTP.session.urlLen == urlLen
+      && hqtel->HTTP.session.urlHash == urlHash)
+  {
+    return QTEL_OK;
+  }
+
+  QTEL_LOCK(hqtel);
+
+  // input url
+  QTEL_SendCMD(hqtel, "AT+QHTTPURL=%u,1000", urlLen);
+  status = QTEL_GetResponse(hqtel, "CONNECT", 7, NULL, 0, QTEL_GETRESP_ONLY_DATA, 0);
+  if (status != QTEL_OK)
+    goto endcmd;
+
+  QTEL_SendData(hqtel, (uint8_t*)req->url, urlLen);
+  if (!QTEL_IsResponseOK(hqtel)) {
+    status = QTEL_ERROR;
+    goto endcmd;
+  }
+
+  if (hqtel->HTTP.session.isActive) {
+    hqtel->HTTP.session.urlLen = urlLen;
+    hqtel->HTTP.session.urlHash = urlHash;
+  }
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+/*
+ * outside of session the request is always stopped,
+ * in session the URL is uploaded again after error
+ */
+static void finishRequest(QTEL_HandlerTypeDef *hqtel, uint8_t isError)
+{
+  if (!hqtel->HTTP.session.isActive || isError) {
+    QTEL_HTTP_Stop(hqtel);
+    hqtel->HTTP.session.urlLen = 0;
+  }
+  QTEL_HTTP_UNSET_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING);
+}
+
+
+// FNV-1a
+static uint32_t hashStr(const char *str, uint16_t len)
+{
+  uint32_t hash = 2166136261UL;
+
+  while (len--) {
+    hash ^= (uint8_t) *str++;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+
 static QTEL_Status_t setDefaultConfig(QTEL_HandlerTypeDef *hqtel)
 {
   int isReqHeader = 0;
@@ -231,6 +592,7 @@ static QTEL_Status_t setDefaultConfig(QTEL_HandlerTypeDef *hqtel)
   int isClosedInd = 0;
 
   QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_ReqHeader, &isReqHeader);
+  hqtel->HTTP.isReqHeader = 0;
   QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_RespHeader, &isRespHeader);
   QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_RespAuto, &isRespOutAuto);
   QTEL_HTTP_Config(hqtel, QTEL_HTTP_CFG_ClosedInd, &isClosedInd);
@@ -239,32 +601,662 @@ static QTEL_Status_t setDefaultConfig(QTEL_HandlerTypeDef *hqtel)
 }
 
 
-static uint16_t parseHeader(uint8_t *srcbuf, uint16_t bufLen, uint8_t *isHeaderClosed)
+/*
+ * send GET or POST then wait for its result
+ */
+static QTEL_Status_t sendRequest(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
 {
-  uint16_t i = 0;
-  uint16_t readlen = 0;
-  uint8_t oneHeaderLen = 0;
-  uint8_t prevByte = 0;
-  uint8_t curByte = 0;
-
-  *isHeaderClosed = 0;
-
-  for (i = 0; i < bufLen; i++) {
-    if (prevByte == '\r' && curByte == '\n') {
-      if(oneHeaderLen == 2) {
-        *isHeaderClosed = 1;
-        oneHeaderLen = 0;
-        break;
+  QTEL_Status_t status;
+  uint8_t       *resp     = &hqtel->respTmp[0];
+  const char    *respCode = getRespCode(req);
+
+  status = startRequest(hqtel, req);
+  if (status != QTEL_OK) return status;
+
+  // wait response
+  memset(resp, 0, 24);
+  status = QTEL_GetResponse(hqtel, respCode, strlen(respCode), resp, 24, QTEL_GETRESP_ONLY_DATA, req->timeout);
+  if (status != QTEL_OK) return status;
+
+  return parseResult(hqtel, resp);
+}
+
+
+/*
+ * send GET or POST command, its result comes later as URC
+ */
+static QTEL_Status_t startRequest(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  QTEL_Status_t status;
+  uint32_t      timeout = req->timeout;
+
+  if (req->method == QTEL_HTTP_GET && hqtel->HTTP.isReqHeader) {
+    return sendRequestHeader(hqtel, req);
+  }
+  else if (req->method == QTEL_HTTP_GET) {
+    QTEL_SendCMD(hqtel, "AT+QHTTPGET=%d", (timeout/1000));
+    if (!QTEL_IsResponseOK(hqtel)) return QTEL_ERROR;
+  }
+  else if (req->body.filename != NULL) {
+    QTEL_SendCMD(hqtel, "AT+QHTTPPOSTFILE=\"%s\",%d", req->body.filename, (timeout/1000));
+    if (!QTEL_IsResponseOK(hqtel)) return QTEL_ERROR;
+  }
+  else {
+    QTEL_SendCMD(hqtel, "AT+QHTTPPOST=%lu,%u,%d",
+                 (unsigned long) req->body.length, (uint) getInputTime(req), (timeout/1000));
+    status = QTEL_GetResponse(hqtel, "CONNECT", 7, NULL, 0, QTEL_GETRESP_ONLY_DATA, 5000);
+    if (status != QTEL_OK) return status;
+    status = sendBody(hqtel, req);
+    if (status != QTEL_OK) return status;
+    if (!QTEL_IsResponseOK(hqtel)) return QTEL_ERROR;
+  }
+  return QTEL_OK;
+}
+
+
+/*
+ * GET in requestheader mode, the header is sent after CONNECT:
+ * "GET <path> HTTP/1.1\r\nHost: <host>\r\n<customHeader>\r\n\r\n"
+ */
+static QTEL_Status_t sendRequestHeader(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  QTEL_Status_t status;
+  const char    *host = strstr(req->url, "://");
+  const char    *path;
+  uint16_t      hostLen;
+  uint32_t      headerLen;
+
+  host = (host == NULL)? req->url : host + 3;
+  path = strchr(host, '/');
+  hostLen = (path == NULL)? (uint16_t) strlen(host) : (uint16_t) (path - host);
+  if (path == NULL) path = "/";
+
+  headerLen = 4 + strlen(path) + 11 + 6 + hostLen + 2 + strlen(req->customHeader) + 4;
+  QTEL_SendCMD(hqtel, "AT+QHTTPGET=%d,%lu", (req->timeout/1000), (unsigned long) headerLen);
+  status = QTEL_GetResponse(hqtel, "CONNECT", 7, NULL, 0, QTEL_GETRESP_ONLY_DATA, 5000);
+  if (status != QTEL_OK) return status;
+
+  QTEL_SendData(hqtel, (const uint8_t*) "GET ", 4);
+  QTEL_SendData(hqtel, (const uint8_t*) path, strlen(path));
+  QTEL_SendData(hqtel, (const uint8_t*) " HTTP/1.1\r\nHost: ", 17);
+  QTEL_SendData(hqtel, (const uint8_t*) host, hostLen);
+  QTEL_SendData(hqtel, (const uint8_t*) "\r\n", 2);
+  QTEL_SendData(hqtel, (const uint8_t*) req->customHeader, strlen(req->customHeader));
+  QTEL_SendData(hqtel, (const uint8_t*) "\r\n\r\n", 4);
+  if (!QTEL_IsResponseOK(hqtel)) return QTEL_ERROR;
+  return QTEL_OK;
+}
+
+
+static const char* getRespCode(QTEL_HTTP_Request_t *req)
+{
+  if (req->method == QTEL_HTTP_GET) return "+QHTTPGET";
+  if (req->body.filename != NULL)   return "+QHTTPPOSTFILE";
+  return "+QHTTPPOST";
+}
+
+
+/*
+ * <err>[,<httprspcode>[,<content_length>]]
+ */
+static QTEL_Status_t parseResult(QTEL_HandlerTypeDef *hqtel, const uint8_t *resp)
+{
+  char          strTmp[12];                 // also called from URC, respTmp may be in use
+  const uint8_t *nextBuf;
+
+  memset(strTmp, 0, sizeof(strTmp));
+  nextBuf = QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  hqtel->HTTP.response.error = (uint16_t) atoi(strTmp);
+  if (hqtel->HTTP.response.error != 0) return QTEL_ERROR;
+
+  memset(strTmp, 0, sizeof(strTmp));
+  nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  hqtel->HTTP.response.code = (uint16_t) atoi(strTmp);
+
+  memset(strTmp, 0, sizeof(strTmp));
+  QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  hqtel->HTTP.response.contentLen = (uint32_t) atoi(strTmp);
+
+  return QTEL_OK;
+}
+
+
+/*
+ * send body after CONNECT, data of producer is pulled per cmdTmp size
+ */
+static QTEL_Status_t sendBody(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  uint32_t  sentLen = 0;
+  uint16_t  chunkLen;
+
+  if (req->body.producer == NULL) {
+    while (sentLen < req->body.length) {
+      chunkLen = (req->body.length - sentLen > 1024) ? 1024 : (uint16_t) (req->body.length - sentLen);
+      if (!QTEL_SendData(hqtel, &req->body.data[sentLen], chunkLen)) {
+        abortBody(hqtel, req);
+        return QTEL_ERROR;
+      }
+      sentLen += chunkLen;
+    }
+    return QTEL_OK;
+  }
+
+  while (sentLen < req->body.length) {
+    chunkLen = QTEL_TMP_RESP_BUFFER_SIZE;
+    if (chunkLen > req->body.length - sentLen) chunkLen = (uint16_t) (req->body.length - sentLen);
+    chunkLen = req->body.producer(req->body.ctx, &hqtel->cmdTmp[0], chunkLen);
+
+    // the modem waits for declared length, the body is given up when it ends early
+    if (chunkLen == 0 || !QTEL_SendData(hqtel, &hqtel->cmdTmp[0], chunkLen)) {
+      abortBody(hqtel, req);
+      return QTEL_ERROR;
+    }
+    sentLen += chunkLen;
+  }
+  return QTEL_OK;
+}
+
+
+/*
+ * s, time for the modem to receive the whole body,
+ * kept short so an aborted body expires soon
+ */
+static uint16_t getInputTime(QTEL_HTTP_Request_t *req)
+{
+  uint32_t inputTime = QTEL_HTTP_POST_INPUT_TIME + req->body.length / QTEL_HTTP_POST_INPUT_RATE;
+
+  return (inputTime > 65535)? 65535 : (uint16_t) inputTime;
+}
+
+
+/*
+ * the modem stays in data mode until declared length is received,
+ * padding would be sent as a real body, so the input time is let to expire
+ * and the request is never sent, its error is taken before AT+QHTTPSTOP
+ */
+static void abortBody(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  uint32_t timeout = ((uint32_t) getInputTime(req) + 5) * 1000;
+
+  if (QTEL_GetResponse(hqtel, NULL, 0, NULL, 0, QTEL_GETRESP_WAIT_OK, timeout) != QTEL_OK) {}
+}
+
+
+/*
+ * read response with AT+QHTTPREAD, the header is read per line
+ * then the content is passed to reader as it comes from serial,
+ * chunked content is read only as far as the decoder needs
+ * so the final result isn't taken as content
+ */
+static QTEL_Status_t readStream(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  QTEL_Status_t status;
+  uint8_t       *resp         = &hqtel->respTmp[0];
+  uint8_t       *contentBuf   = req->contentBuf;
+  uint16_t      contentBufLen = req->contentBufLen;
+  uint16_t      tmpReadlen;
+  uint16_t      lineLen;
+
+  QTEL_SendCMD(hqtel, "AT+QHTTPREAD=60");
+  status = QTEL_GetResponse(hqtel, "CONNECT", 7, NULL, 0, QTEL_GETRESP_ONLY_DATA, 5000);
+  if (status != QTEL_OK) return status;
+
+  beginResponse(hqtel);
+  while (!hqtel->HTTP.header.isClosed) {
+    lineLen = hqtel->serial.readline(hqtel->serial.device, hqtel->respBuffer, QTEL_RESP_BUFFER_SIZE, 5000);
+    if (lineLen == 0) return QTEL_TIMEOUT;
+    readResponse(hqtel, req, hqtel->respBuffer, lineLen);
+  }
+
+  while (!isResponseEnd(hqtel)) {
+    if (hqtel->HTTP.header.isChunked) {
+      tmpReadlen = 1;
+      if (hqtel->HTTP.header.chunkState == CHUNK_DATA) {
+        tmpReadlen = contentBufLen;
+        if (tmpReadlen > hqtel->HTTP.header.chunkLeft) tmpReadlen = (uint16_t) hqtel->HTTP.header.chunkLeft;
+      }
+    }
+    else {
+      if (hqtel->HTTP.header.contentLen == QTEL_HTTP_CONTENT_LEN_UNKNOWN)
+        return readUntilTrailer(hqtel, req);
+      tmpReadlen = contentBufLen;
+      if (tmpReadlen > hqtel->HTTP.header.contentLen - hqtel->HTTP.header.contentRead)
+        tmpReadlen = (uint16_t) (hqtel->HTTP.header.contentLen - hqtel->HTTP.header.contentRead);
+    }
+
+    tmpReadlen = QTEL_GetData(hqtel, contentBuf, tmpReadlen, 5000);
+    if (tmpReadlen == 0) return QTEL_TIMEOUT;
+    readResponse(hqtel, req, contentBuf, tmpReadlen);
+  }
+
+  memset(resp, 0, 8);
+  status = QTEL_GetResponse(hqtel, "+QHTTPREAD", 10, resp, 8, QTEL_GETRESP_ONLY_DATA, 60000);
+  if (status != QTEL_OK) return status;
+
+  hqtel->HTTP.response.error = (uint16_t) atoi((char*) resp);
+  if (hqtel->HTTP.response.error != 0) return QTEL_ERROR;
+  return endContent(hqtel);
+}
+
+
+/*
+ * content length of the request result is used
+ * until the header gives it
+ */
+static void beginResponse(QTEL_HandlerTypeDef *hqtel)
+{
+  memset(&hqtel->HTTP.header, 0, sizeof(hqtel->HTTP.header));
+  hqtel->HTTP.header.contentLen = QTEL_HTTP_CONTENT_LEN_UNKNOWN;
+  if (hqtel->HTTP.response.contentLen != 0)
+    hqtel->HTTP.header.contentLen = hqtel->HTTP.response.contentLen;
+}
+
+
+/*
+ * data can be cut anywhere, the rest of header is kept in header.line
+ */
+static void readResponse(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req,
+                         const uint8_t *data, uint16_t dataLen)
+{
+  uint16_t headerLen = 0;
+
+  hqtel->HTTP.reqTmpPtr = req;
+  if (!hqtel->HTTP.header.isClosed) {
+    headerLen = parseHeader(hqtel, req, data, dataLen);
+    if (hqtel->HTTP.header.isClosed) beginContent(hqtel);
+  }
+  if (headerLen < dataLen)
+    decodeContent(hqtel, req, &data[headerLen], dataLen - headerLen);
+}
+
+
+/*
+ * content without length and chunks ends where READ_TRAILER begins,
+ * a read never goes past the trailer so <err> is left for readline.
+ * bytes which may be the start of the trailer are held until they don't match
+ */
+static QTEL_Status_t readUntilTrailer(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  const uint8_t *trailer  = (const uint8_t*) READ_TRAILER;
+  uint8_t       border[READ_TRAILER_LEN];
+  uint8_t       data[READ_TRAILER_LEN];
+  uint8_t       matchLen  = 0;
+  uint8_t       k;
+  uint16_t      bufLen    = 0;
+  uint16_t      readLen;
+  uint16_t      i;
+
+  if (req->contentBuf == NULL || req->contentBufLen == 0) return QTEL_ERROR;
+
+  // border of each prefix, the held bytes are matched again from there
+  border[0] = 0;
+  for (i = 1, k = 0; i < READ_TRAILER_LEN; i++) {
+    while (k && trailer[i] != trailer[k]) k = border[k-1];
+    if (trailer[i] == trailer[k]) k++;
+    border[i] = k;
+  }
+
+  while (matchLen < READ_TRAILER_LEN) {
+    readLen = QTEL_GetData(hqtel, data, READ_TRAILER_LEN - matchLen, 5000);
+    if (readLen == 0) return QTEL_TIMEOUT;
+
+    for (i = 0; i < readLen; i++) {
+      while (matchLen && data[i] != trailer[matchLen]) {
+        k = border[matchLen-1];
+        bufLen = putContent(hqtel, req, bufLen, trailer, matchLen - k);
+        matchLen = k;
+      }
+      if (data[i] == trailer[matchLen]) matchLen++;
+      else bufLen = putContent(hqtel, req, bufLen, &data[i], 1);
+    }
+  }
+  if (bufLen) readResponse(hqtel, req, req->contentBuf, bufLen);
+
+  readLen = hqtel->serial.readline(hqtel->serial.device, hqtel->respBuffer, QTEL_RESP_BUFFER_SIZE, 5000);
+  if (readLen == 0) return QTEL_TIMEOUT;
+  hqtel->respBuffer[readLen] = 0;
+
+  hqtel->HTTP.response.error = (uint16_t) atoi((char*) hqtel->respBuffer);
+  if (hqtel->HTTP.response.error != 0) return QTEL_ERROR;
+  return endContent(hqtel);
+}
+
+
+/*
+ * collect content in contentBuf, it is passed on when full
+ */
+static uint16_t putContent(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req, uint16_t bufLen,
+                           const uint8_t *data, uint16_t dataLen)
+{
+  while (dataLen--) {
+    req->contentBuf[bufLen++] = *data++;
+    if (bufLen == req->contentBufLen) {
+      readResponse(hqtel, req, req->contentBuf, bufLen);
+      bufLen = 0;
+    }
+  }
+  return bufLen;
+}
+
+
+static uint8_t isResponseEnd(QTEL_HandlerTypeDef *hqtel)
+{
+  if (!hqtel->HTTP.header.isClosed) return 0;
+  if (hqtel->HTTP.header.isChunked) return (hqtel->HTTP.header.chunkState == CHUNK_DONE);
+  return (hqtel->HTTP.header.contentLen != QTEL_HTTP_CONTENT_LEN_UNKNOWN
+          && hqtel->HTTP.header.contentRead >= hqtel->HTTP.header.contentLen);
+}
+
+
+/*
+ * return length of data which belongs to header
+ */
+static uint16_t parseHeader(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req,
+                            const uint8_t *data, uint16_t dataLen)
+{
+  uint16_t i;
+
+  for (i = 0; i < dataLen && !hqtel->HTTP.header.isClosed; i++) {
+    if (data[i] == '\r') continue;
+
+    if (data[i] != '\n') {
+      if (hqtel->HTTP.header.lineLen < QTEL_HTTP_HEADER_LINE_SIZE) {
+        if (hqtel->HTTP.header.lineLen < QTEL_HTTP_HEADER_LINE_SIZE-1)
+          hqtel->HTTP.header.line[hqtel->HTTP.header.lineLen] = (char) data[i];
+        hqtel->HTTP.header.lineLen++;
       }
-      oneHeaderLen = 0;
+      continue;
     }
 
-    prevByte = curByte;
-    curByte = *srcbuf;
-    srcbuf++;
-    readlen++;
-    oneHeaderLen++;
+    if (hqtel->HTTP.header.lineLen == 0) {
+      hqtel->HTTP.header.isClosed = 1;
+    }
+    else if (hqtel->HTTP.header.lineLen < QTEL_HTTP_HEADER_LINE_SIZE) {
+      hqtel->HTTP.header.line[hqtel->HTTP.header.lineLen] = 0;
+      parseHeaderLine(hqtel, req);
+    }
+    hqtel->HTTP.header.lineLen = 0;
+  }
+
+  return i;
+}
+
+
+static void parseHeaderLine(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req)
+{
+  const char  *line     = hqtel->HTTP.header.line;
+  uint16_t    lineLen   = hqtel->HTTP.header.lineLen;
+  const char  *value;
+  uint16_t    valueLen;
+
+  if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "content-length", &valueLen)) != NULL) {
+    hqtel->HTTP.header.contentLen = (uint32_t) strtoul(value, NULL, 10);
+    if (hqtel->HTTP.response.contentLen == 0)
+      hqtel->HTTP.response.contentLen = hqtel->HTTP.header.contentLen;
+  }
+  else if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "content-type", &valueLen)) != NULL) {
+    copyHeaderValue(hqtel->HTTP.header.contentType, QTEL_HTTP_CONTENT_TYPE_SIZE, value, valueLen);
+  }
+  else if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "content-encoding", &valueLen)) != NULL) {
+    if (valueLen == 4 && strncmp(value, "gzip", 4) == 0)
+      hqtel->HTTP.header.encoding = QTEL_HTTP_ENCODING_GZIP;
+    else if (valueLen == 7 && strncmp(value, "deflate", 7) == 0)
+      hqtel->HTTP.header.encoding = QTEL_HTTP_ENCODING_DEFLATE;
+    else if (valueLen == 8 && strncmp(value, "identity", 8) == 0)
+      hqtel->HTTP.header.encoding = QTEL_HTTP_ENCODING_IDENTITY;
+    else
+      hqtel->HTTP.header.encoding = QTEL_HTTP_ENCODING_UNKNOWN;
+  }
+  else if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "etag", &valueLen)) != NULL) {
+    copyHeaderValue(hqtel->HTTP.header.etag, QTEL_HTTP_ETAG_SIZE, value, valueLen);
+  }
+  else if ((value = QTEL_HTTP_GetHeaderValue(line, lineLen, "transfer-encoding", &valueLen)) != NULL) {
+    // chunked is always the last coding
+    hqtel->HTTP.header.isChunked = (valueLen >= 7 && strncmp(&value[valueLen-7], "chunked", 7) == 0);
+  }
+
+  if (req->onHeader != NULL) req->onHeader(hqtel, line, lineLen);
+}
+
+
+/*
+ * pass content to reader without chunked encoding,
+ * chunk data are passed directly from the given data
+ */
+static void decodeContent(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req,
+                          const uint8_t *data, uint16_t dataLen)
+{
+  uint16_t  i = 0;
+  uint16_t  len;
+  uint8_t   c;
+
+  hqtel->HTTP.header.contentRead += dataLen;
+
+  if (!hqtel->HTTP.header.isChunked) {
+    passContent(hqtel, req, data, dataLen);
+    return;
+  }
+
+  while (i < dataLen && hqtel->HTTP.header.chunkState != CHUNK_DONE) {
+    c = data[i];
+
+    switch (hqtel->HTTP.header.chunkState) {
+    case CHUNK_SIZE:
+      if (c >= '0' && c <= '9')       hqtel->HTTP.header.chunkLeft = (hqtel->HTTP.header.chunkLeft << 4) | (c - '0');
+      else if (c >= 'a' && c <= 'f')  hqtel->HTTP.header.chunkLeft = (hqtel->HTTP.header.chunkLeft << 4) | (c - 'a' + 10);
+      else if (c >= 'A' && c <= 'F')  hqtel->HTTP.header.chunkLeft = (hqtel->HTTP.header.chunkLeft << 4) | (c - 'A' + 10);
+      else if (c == '\n')
+        hqtel->HTTP.header.chunkState = (hqtel->HTTP.header.chunkLeft)? CHUNK_DATA : CHUNK_TRAILER;
+      else
+        hqtel->HTTP.header.chunkState = CHUNK_EXT;
+      i++;
+      break;
+
+    case CHUNK_EXT:
+      if (c == '\n')
+        hqtel->HTTP.header.chunkState = (hqtel->HTTP.header.chunkLeft)? CHUNK_DATA : CHUNK_TRAILER;
+      i++;
+      break;
+
+    case CHUNK_DATA:
+      len = dataLen - i;
+      if (len > hqtel->HTTP.header.chunkLeft) len = (uint16_t) hqtel->HTTP.header.chunkLeft;
+      passContent(hqtel, req, &data[i], len);
+      hqtel->HTTP.header.chunkLeft -= len;
+      if (hqtel->HTTP.header.chunkLeft == 0) hqtel->HTTP.header.chunkState = CHUNK_DATA_END;
+      i += len;
+      break;
+
+    case CHUNK_DATA_END:
+      if (c == '\n') hqtel->HTTP.header.chunkState = CHUNK_SIZE;
+      i++;
+      break;
+
+    case CHUNK_TRAILER:
+      // trailer lines until the empty one, lineLen is free after the header
+      if (c == '\n') {
+        if (hqtel->HTTP.header.lineLen == 0) hqtel->HTTP.header.chunkState = CHUNK_DONE;
+        hqtel->HTTP.header.lineLen = 0;
+      }
+      else if (c != '\r') hqtel->HTTP.header.lineLen = 1;
+      i++;
+      break;
+    }
+  }
+}
+
+
+static void copyHeaderValue(char *dst, uint16_t dstSize, const char *value, uint16_t valueLen)
+{
+  if (valueLen >= dstSize) valueLen = dstSize - 1;
+  memcpy(dst, value, valueLen);
+  dst[valueLen] = 0;
+}
+
+
+static void beginContent(QTEL_HandlerTypeDef *hqtel)
+{
+#if QTEL_EN_FEATURE_INFLATE
+  if (hqtel->HTTP.inflater == NULL) return;
+
+  if (hqtel->HTTP.header.encoding == QTEL_HTTP_ENCODING_GZIP) {
+    QTEL_Inflate_Begin(hqtel->HTTP.inflater, QTEL_INFLATE_FORMAT_GZIP, writeInflated, hqtel);
+    hqtel->HTTP.header.isInflating = 1;
   }
-  return readlen-oneHeaderLen;
+  else if (hqtel->HTTP.header.encoding == QTEL_HTTP_ENCODING_DEFLATE) {
+    QTEL_Inflate_Begin(hqtel->HTTP.inflater, QTEL_INFLATE_FORMAT_ZLIB, writeInflated, hqtel);
+    hqtel->HTTP.header.isInflating = 1;
+  }
+#endif
+}
+
+
+/*
+ * content without transfer encoding, decompressed if it's possible
+ */
+static void passContent(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Request_t *req,
+                        const uint8_t *data, uint16_t dataLen)
+{
+#if QTEL_EN_FEATURE_INFLATE
+  if (hqtel->HTTP.header.isInflating) {
+    if (hqtel->HTTP.header.isDecodeError) return;
+    if (QTEL_Inflate_Write(hqtel->HTTP.inflater, data, dataLen) != QTEL_OK)
+      hqtel->HTTP.header.isDecodeError = 1;
+    return;
+  }
+#endif
+
+  if (req->onContent != NULL)
+    req->onContent(hqtel, data, dataLen, hqtel->HTTP.response.contentLen);
+}
+
+
+/*
+ * compressed content must be complete
+ */
+static QTEL_Status_t endContent(QTEL_HandlerTypeDef *hqtel)
+{
+  if (hqtel->HTTP.header.isDecodeError) return QTEL_ERROR;
+#if QTEL_EN_FEATURE_INFLATE
+  if (hqtel->HTTP.header.isInflating && !QTEL_Inflate_IsDone(hqtel->HTTP.inflater))
+    return QTEL_ERROR;
+#endif
+  return QTEL_OK;
+}
+
+
+#if QTEL_EN_FEATURE_INFLATE
+static void writeInflated(void *ctx, const uint8_t *data, uint16_t length)
+{
+  QTEL_HandlerTypeDef *hqtel = (QTEL_HandlerTypeDef*) ctx;
+  QTEL_HTTP_Request_t *req = (QTEL_HTTP_Request_t*) hqtel->HTTP.reqTmpPtr;
+
+  if (req != NULL && req->onContent != NULL)
+    req->onContent(hqtel, data, length, 0);
+}
+#endif
+
+
+/*
+ * start request of the queue, LOCK is only taken per command
+ */
+static void startAsync(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Async_t *async)
+{
+  QTEL_Status_t status;
+
+  QTEL_HTTP_SET_STATUS(hqtel, QTEL_HTTP_STATUS_REQUESTING);
+  hqtel->HTTP.lastUrl = async->request.url;
+  hqtel->HTTP.response.error = 0;
+  hqtel->HTTP.response.code = 0;
+  hqtel->HTTP.response.contentLen = 0;
+
+  status = prepareRequest(hqtel, &async->request);
+  if (status != QTEL_OK) {
+    completeAsync(hqtel, async, status);
+    return;
+  }
+
+  QTEL_LOCK(hqtel);
+  async->tick = QTEL_GetTick();
+  status = startRequest(hqtel, &async->request);
+  if (status == QTEL_OK) async->state = QTEL_HTTP_ASYNC_WAIT_RESP;
+  QTEL_UNLOCK(hqtel);
+
+  if (status != QTEL_OK) completeAsync(hqtel, async, status);
+}
+
+
+static void readAsyncFile(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Async_t *async)
+{
+  if (async->request.contentBuf == NULL) {
+    completeAsync(hqtel, async, QTEL_OK);
+    return;
+  }
+
+  hqtel->HTTP.counterIdTmpFile++;
+  sprintf(async->filename, TMP_FILE_FORMAT, hqtel->HTTP.counterIdTmpFile);
+
+  QTEL_LOCK(hqtel);
+  async->tick = QTEL_GetTick();
+  QTEL_SendCMD(hqtel, "AT+QHTTPREADFILE=\"RAM:%s\",60", async->filename);
+  if (QTEL_IsResponseOK(hqtel)) async->state = QTEL_HTTP_ASYNC_WAIT_FILE;
+  QTEL_UNLOCK(hqtel);
+
+  if (async->state != QTEL_HTTP_ASYNC_WAIT_FILE) completeAsync(hqtel, async, QTEL_ERROR);
+}
+
+
+/*
+ * a buffer of the file is read per call
+ */
+static void readAsyncContent(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Async_t *async)
+{
+  QTEL_HTTP_Request_t *req = &async->request;
+  int32_t             readLen;
+
+  readLen = QTEL_File_Read(&async->file, req->contentBuf, req->contentBufLen);
+  if (readLen <= 0) {
+    // only content without length and chunks ends with the file,
+    // otherwise the file is shorter than announced
+    if (readLen == 0
+        && hqtel->HTTP.header.isClosed
+        && !hqtel->HTTP.header.isChunked
+        && hqtel->HTTP.header.contentLen == QTEL_HTTP_CONTENT_LEN_UNKNOWN)
+    {
+      completeAsync(hqtel, async, endContent(hqtel));
+    }
+    else completeAsync(hqtel, async, QTEL_ERROR);
+    return;
+  }
+
+  readResponse(hqtel, req, req->contentBuf, (uint16_t) readLen);
+  if (hqtel->HTTP.header.isClosed) async->state = QTEL_HTTP_ASYNC_READ_CONTENT;
+  if (isResponseEnd(hqtel)) completeAsync(hqtel, async, endContent(hqtel));
+}
+
+
+/*
+ * release the request from the queue before its callback,
+ * so the callback can submit another one
+ */
+static void completeAsync(QTEL_HandlerTypeDef *hqtel, QTEL_HTTP_Async_t *async, QTEL_Status_t status)
+{
+  if (async->state == QTEL_HTTP_ASYNC_READ_HEADER || async->state == QTEL_HTTP_ASYNC_READ_CONTENT)
+    QTEL_File_Close(&async->file);
+  if (async->state >= QTEL_HTTP_ASYNC_WAIT_FILE && async->filename[0] != 0)
+    QTEL_File_Delete(hqtel, QTEL_File_Storage_RAM, async->filename);
+
+  finishRequest(hqtel, (status != QTEL_OK));
+
+  async->status = status;
+  async->error = hqtel->HTTP.response.error;
+  async->code = hqtel->HTTP.response.code;
+  async->contentLen = hqtel->HTTP.response.contentLen;
+  async->state = QTEL_HTTP_ASYNC_DONE;
+
+  hqtel->HTTP.queue.head = (hqtel->HTTP.queue.head + 1) % QTEL_HTTP_QUEUE_SIZE;
+  hqtel->HTTP.queue.count--;
+
+  if (async->onComplete != NULL) async->onComplete(hqtel, async);
 }
 #endif /* QTEL_EN_FEATURE_HTTP */
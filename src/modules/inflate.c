@@ -0,0 +1,580 @@
+/*
+ * inflate.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel/conf.h"
+#include "../include/quectel/inflate.h"
+#include "../include/quectel/digest.h"
+#include <string.h>
+
+#if QTEL_EN_FEATURE_INFLATE
+
+#define WINDOW_MASK (QTEL_INFLATE_WINDOW_SIZE - 1)
+
+#define STATE_GZ_HEADER     0
+#define STATE_GZ_EXTRA_LEN  1
+#define STATE_GZ_SKIP       2
+#define STATE_GZ_STRING     3
+#define STATE_ZLIB_HEADER   4
+#define STATE_BLOCK_HEADER  5
+#define STATE_STORED_LEN    6
+#define STATE_STORED_NLEN   7
+#define STATE_STORED_DATA   8
+#define STATE_DYN_HEADER    9
+#define STATE_DYN_CODELEN   10
+#define STATE_DYN_LENGTHS   11
+#define STATE_LITLEN        12
+#define STATE_DIST          13
+#define STATE_DIST_EXTRA    14
+#define STATE_TRAILER       15
+#define STATE_DONE          16
+#define STATE_ERROR         17
+
+// result of a step
+#define STEP_NEXT   0
+#define STEP_NEED   1
+
+#define GZ_FHCRC    0x02
+#define GZ_FEXTRA   0x04
+#define GZ_FNAME    0x08
+#define GZ_FCOMMENT 0x10
+
+static const uint16_t lengthBase[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t lengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t distBase[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t distExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const uint8_t codeLenOrder[19] = {
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+static uint8_t  step(QTEL_Inflate_t*);
+static uint8_t  stepHeader(QTEL_Inflate_t*);
+static uint8_t  stepDynamic(QTEL_Inflate_t*);
+static uint8_t  stepData(QTEL_Inflate_t*);
+static void     nextGzipField(QTEL_Inflate_t*);
+static void     endBlock(QTEL_Inflate_t*);
+static uint16_t getBits(QTEL_Inflate_t*, uint8_t n);
+static int16_t  decode(QTEL_Inflate_t*, const uint16_t *count, const uint16_t *symbol, uint8_t *codeLen);
+static int16_t  build(uint16_t *count, uint16_t *symbol, const uint8_t *length, uint16_t n);
+static void     buildFixed(QTEL_Inflate_t*);
+static void     putByte(QTEL_Inflate_t*, uint8_t b);
+static void     flush(QTEL_Inflate_t*);
+
+
+void QTEL_Inflate_Begin(QTEL_Inflate_t *inf, uint8_t format, QTEL_Inflate_Output_Func onOutput, void *ctx)
+{
+  inf->onOutput = onOutput;
+  inf->ctx = ctx;
+  inf->format = format;
+  inf->isFinal = 0;
+  inf->gzFlags = 0;
+  inf->bitBuf = 0;
+  inf->bitCnt = 0;
+  inf->counter = 0;
+  inf->crc = (format == QTEL_INFLATE_FORMAT_ZLIB)? 1 : 0;
+  inf->total = 0;
+  inf->windowPos = 0;
+  inf->flushPos = 0;
+
+  if (format == QTEL_INFLATE_FORMAT_GZIP)       inf->state = STATE_GZ_HEADER;
+  else if (format == QTEL_INFLATE_FORMAT_ZLIB)  inf->state = STATE_ZLIB_HEADER;
+  else                                          inf->state = STATE_BLOCK_HEADER;
+}
+
+
+/**
+ * decode a piece of compressed data, the output is passed
+ * to onOutput at least once per call
+ */
+QTEL_Status_t QTEL_Inflate_Write(QTEL_Inflate_t *inf, const uint8_t *data, uint16_t length)
+{
+  uint16_t i = 0;
+
+  while (inf->state != STATE_DONE && inf->state != STATE_ERROR) {
+    // every step needs 20 bits at most
+    while (inf->bitCnt <= 24 && i < length) {
+      inf->bitBuf |= (uint32_t) data[i++] << inf->bitCnt;
+      inf->bitCnt += 8;
+    }
+    if (step(inf) == STEP_NEED && i >= length) break;
+  }
+  flush(inf);
+
+  return (inf->state == STATE_ERROR)? QTEL_ERROR : QTEL_OK;
+}
+
+
+uint8_t QTEL_Inflate_IsDone(QTEL_Inflate_t *inf)
+{
+  return inf->state == STATE_DONE;
+}
+
+
+static uint8_t step(QTEL_Inflate_t *inf)
+{
+  switch (inf->state) {
+  case STATE_GZ_HEADER:
+  case STATE_GZ_EXTRA_LEN:
+  case STATE_GZ_SKIP:
+  case STATE_GZ_STRING:
+  case STATE_ZLIB_HEADER:
+  case STATE_TRAILER:
+    return stepHeader(inf);
+
+  case STATE_DYN_HEADER:
+  case STATE_DYN_CODELEN:
+  case STATE_DYN_LENGTHS:
+    return stepDynamic(inf);
+
+  case STATE_BLOCK_HEADER:
+    if (inf->bitCnt < 3) return STEP_NEED;
+    inf->isFinal = (uint8_t) getBits(inf, 1);
+    switch (getBits(inf, 2)) {
+    case 0:
+      getBits(inf, inf->bitCnt & 7);
+      inf->state = STATE_STORED_LEN;
+      break;
+    case 1:
+      buildFixed(inf);
+      inf->state = STATE_LITLEN;
+      break;
+    case 2:
+      inf->state = STATE_DYN_HEADER;
+      break;
+    default:
+      inf->state = STATE_ERROR;
+      break;
+    }
+    return STEP_NEXT;
+
+  default:
+    return stepData(inf);
+  }
+}
+
+
+/*
+ * gzip and zlib wrapper, read per byte
+ */
+static uint8_t stepHeader(QTEL_Inflate_t *inf)
+{
+  uint8_t b;
+
+  switch (inf->state) {
+  case STATE_GZ_HEADER:
+    if (inf->bitCnt < 8) return STEP_NEED;
+    b = (uint8_t) getBits(inf, 8);
+    if ((inf->counter == 0 && b != 0x1F)
+        || (inf->counter == 1 && b != 0x8B)
+        || (inf->counter == 2 && b != 8))
+    {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    if (inf->counter == 3) inf->gzFlags = b;
+    // skip MTIME, XFL and OS
+    if (++inf->counter == 10) nextGzipField(inf);
+    return STEP_NEXT;
+
+  case STATE_GZ_EXTRA_LEN:
+    if (inf->bitCnt < 16) return STEP_NEED;
+    inf->counter = getBits(inf, 16);
+    inf->state = STATE_GZ_SKIP;
+    if (inf->counter == 0) nextGzipField(inf);
+    return STEP_NEXT;
+
+  case STATE_GZ_SKIP:
+    if (inf->bitCnt < 8) return STEP_NEED;
+    getBits(inf, 8);
+    if (--inf->counter == 0) nextGzipField(inf);
+    return STEP_NEXT;
+
+  case STATE_GZ_STRING:
+    if (inf->bitCnt < 8) return STEP_NEED;
+    if (getBits(inf, 8) == 0) nextGzipField(inf);
+    return STEP_NEXT;
+
+  case STATE_ZLIB_HEADER:
+    if (inf->bitCnt < 16) return STEP_NEED;
+    b = (uint8_t) (inf->bitBuf & 0xFF);
+    if ((b & 0x0F) != 8 || ((uint16_t) b << 8 | ((inf->bitBuf >> 8) & 0xFF)) % 31 != 0) {
+      // without zlib header
+      inf->format = QTEL_INFLATE_FORMAT_RAW;
+    }
+    else if (getBits(inf, 16) & 0x2000) {
+      // preset dictionary isn't supported
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    inf->state = STATE_BLOCK_HEADER;
+    return STEP_NEXT;
+
+  case STATE_TRAILER:
+    // gzip: CRC32 and ISIZE little endian, zlib: ADLER32 big endian
+    if (inf->bitCnt < 8) return STEP_NEED;
+    if (inf->format == QTEL_INFLATE_FORMAT_ZLIB)
+      inf->trailer = (inf->trailer << 8) | getBits(inf, 8);
+    else
+      inf->trailer |= (uint32_t) getBits(inf, 8) << ((inf->counter & 3) * 8);
+    inf->counter++;
+
+    if (inf->format == QTEL_INFLATE_FORMAT_GZIP && inf->counter == 4) {
+      if (inf->trailer != inf->crc) inf->state = STATE_ERROR;
+      inf->trailer = 0;
+    }
+    else if (inf->format == QTEL_INFLATE_FORMAT_GZIP && inf->counter == 8) {
+      inf->state = (inf->trailer == inf->total)? STATE_DONE : STATE_ERROR;
+    }
+    else if (inf->format == QTEL_INFLATE_FORMAT_ZLIB && inf->counter == 4) {
+      inf->state = (inf->trailer == inf->crc)? STATE_DONE : STATE_ERROR;
+    }
+    return STEP_NEXT;
+  }
+
+  return STEP_NEXT;
+}
+
+
+static uint8_t stepDynamic(QTEL_Inflate_t *inf)
+{
+  int16_t   symbol;
+  uint8_t   codeLen;
+  uint8_t   extra;
+  uint16_t  repeat;
+  uint8_t   value = 0;
+
+  switch (inf->state) {
+  case STATE_DYN_HEADER:
+    if (inf->bitCnt < 14) return STEP_NEED;
+    inf->nlen = getBits(inf, 5) + 257;
+    inf->ndist = getBits(inf, 5) + 1;
+    inf->ncode = getBits(inf, 4) + 4;
+    if (inf->nlen > 286 || inf->ndist > 30) {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    memset(inf->lengths, 0, 19);
+    inf->counter = 0;
+    inf->state = STATE_DYN_CODELEN;
+    return STEP_NEXT;
+
+  case STATE_DYN_CODELEN:
+    if (inf->bitCnt < 3) return STEP_NEED;
+    inf->lengths[codeLenOrder[inf->counter]] = (uint8_t) getBits(inf, 3);
+    if (++inf->counter < inf->ncode) return STEP_NEXT;
+
+    // code length codes are kept in table of literal until the lengths are read
+    if (build(inf->litCount, inf->litSymbol, inf->lengths, 19) != 0) {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    inf->counter = 0;
+    inf->state = STATE_DYN_LENGTHS;
+    return STEP_NEXT;
+
+  case STATE_DYN_LENGTHS:
+    symbol = decode(inf, inf->litCount, inf->litSymbol, &codeLen);
+    if (symbol == -1) return STEP_NEED;
+    if (symbol < 0) {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+
+    if (symbol < 16) {
+      getBits(inf, codeLen);
+      inf->lengths[inf->counter++] = (uint8_t) symbol;
+    }
+    else {
+      extra = (symbol == 16)? 2 : ((symbol == 17)? 3 : 7);
+      if (inf->bitCnt < codeLen + extra) return STEP_NEED;
+      getBits(inf, codeLen);
+
+      if (symbol == 16) {
+        if (inf->counter == 0) {
+          inf->state = STATE_ERROR;
+          return STEP_NEXT;
+        }
+        value = inf->lengths[inf->counter - 1];
+        repeat = 3 + getBits(inf, 2);
+      }
+      else if (symbol == 17) repeat = 3 + getBits(inf, 3);
+      else                   repeat = 11 + getBits(inf, 7);
+
+      if (inf->counter + repeat > inf->nlen + inf->ndist) {
+        inf->state = STATE_ERROR;
+        return STEP_NEXT;
+      }
+      while (repeat--) inf->lengths[inf->counter++] = value;
+    }
+
+    if (inf->counter < inf->nlen + inf->ndist) return STEP_NEXT;
+
+    // end of block code is required, incomplete distance code is allowed
+    if (inf->lengths[256] == 0
+        || build(inf->litCount, inf->litSymbol, inf->lengths, inf->nlen) < 0
+        || build(inf->distCount, inf->distSymbol, &inf->lengths[inf->nlen], inf->ndist) < 0)
+    {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    inf->state = STATE_LITLEN;
+    return STEP_NEXT;
+  }
+
+  return STEP_NEXT;
+}
+
+
+static uint8_t stepData(QTEL_Inflate_t *inf)
+{
+  int16_t   symbol;
+  uint8_t   codeLen;
+  uint16_t  dist;
+
+  switch (inf->state) {
+  case STATE_STORED_LEN:
+    if (inf->bitCnt < 16) return STEP_NEED;
+    inf->counter = getBits(inf, 16);
+    inf->state = STATE_STORED_NLEN;
+    return STEP_NEXT;
+
+  case STATE_STORED_NLEN:
+    if (inf->bitCnt < 16) return STEP_NEED;
+    if ((getBits(inf, 16) ^ inf->counter) != 0xFFFF) {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    if (inf->counter == 0) endBlock(inf);
+    else inf->state = STATE_STORED_DATA;
+    return STEP_NEXT;
+
+  case STATE_STORED_DATA:
+    if (inf->bitCnt < 8) return STEP_NEED;
+    putByte(inf, (uint8_t) getBits(inf, 8));
+    if (--inf->counter == 0) endBlock(inf);
+    return STEP_NEXT;
+
+  case STATE_LITLEN:
+    symbol = decode(inf, inf->litCount, inf->litSymbol, &codeLen);
+    if (symbol == -1) return STEP_NEED;
+    if (symbol < 0 || symbol > 285) {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+
+    if (symbol < 256) {
+      getBits(inf, codeLen);
+      putByte(inf, (uint8_t) symbol);
+      return STEP_NEXT;
+    }
+    if (symbol == 256) {
+      getBits(inf, codeLen);
+      endBlock(inf);
+      return STEP_NEXT;
+    }
+
+    symbol -= 257;
+    if (inf->bitCnt < codeLen + lengthExtra[symbol]) return STEP_NEED;
+    getBits(inf, codeLen);
+    inf->length = lengthBase[symbol] + getBits(inf, lengthExtra[symbol]);
+    inf->state = STATE_DIST;
+    return STEP_NEXT;
+
+  case STATE_DIST:
+    symbol = decode(inf, inf->distCount, inf->distSymbol, &codeLen);
+    if (symbol == -1) return STEP_NEED;
+    if (symbol < 0 || symbol > 29) {
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    getBits(inf, codeLen);
+    inf->distBase = distBase[symbol];
+    inf->distExtra = distExtra[symbol];
+    inf->state = STATE_DIST_EXTRA;
+    return STEP_NEXT;
+
+  case STATE_DIST_EXTRA:
+    if (inf->bitCnt < inf->distExtra) return STEP_NEED;
+    dist = inf->distBase + getBits(inf, inf->distExtra);
+    if (dist > inf->total || dist > QTEL_INFLATE_WINDOW_SIZE) {
+      // too far back or window is too small for the compressor
+      inf->state = STATE_ERROR;
+      return STEP_NEXT;
+    }
+    while (inf->length--) {
+      putByte(inf, inf->window[(uint16_t) (inf->windowPos - dist) & WINDOW_MASK]);
+    }
+    inf->state = STATE_LITLEN;
+    return STEP_NEXT;
+  }
+
+  return STEP_NEXT;
+}
+
+
+static void nextGzipField(QTEL_Inflate_t *inf)
+{
+  if (inf->gzFlags & GZ_FEXTRA) {
+    inf->gzFlags &= ~GZ_FEXTRA;
+    inf->state = STATE_GZ_EXTRA_LEN;
+  }
+  else if (inf->gzFlags & GZ_FNAME) {
+    inf->gzFlags &= ~GZ_FNAME;
+    inf->state = STATE_GZ_STRING;
+  }
+  else if (inf->gzFlags & GZ_FCOMMENT) {
+    inf->gzFlags &= ~GZ_FCOMMENT;
+    inf->state = STATE_GZ_STRING;
+  }
+  else if (inf->gzFlags & GZ_FHCRC) {
+    inf->gzFlags &= ~GZ_FHCRC;
+    inf->counter = 2;
+    inf->state = STATE_GZ_SKIP;
+  }
+  else inf->state = STATE_BLOCK_HEADER;
+}
+
+
+static void endBlock(QTEL_Inflate_t *inf)
+{
+  if (!inf->isFinal) {
+    inf->state = STATE_BLOCK_HEADER;
+    return;
+  }
+
+  // trailer starts at byte boundary, checksum needs all output
+  getBits(inf, inf->bitCnt & 7);
+  flush(inf);
+  inf->counter = 0;
+  inf->trailer = 0;
+  inf->state = (inf->format == QTEL_INFLATE_FORMAT_RAW)? STATE_DONE : STATE_TRAILER;
+}
+
+
+static uint16_t getBits(QTEL_Inflate_t *inf, uint8_t n)
+{
+  uint16_t value;
+
+  if (n == 0) return 0;
+  value = (uint16_t) (inf->bitBuf & ((1UL << n) - 1));
+  inf->bitBuf >>= n;
+  inf->bitCnt -= n;
+  return value;
+}
+
+
+/*
+ * canonical Huffman code is read bit by bit without consuming it,
+ * return -1 if more bits are needed, -2 for invalid code
+ */
+static int16_t decode(QTEL_Inflate_t *inf, const uint16_t *count, const uint16_t *symbol, uint8_t *codeLen)
+{
+  uint32_t  bits  = inf->bitBuf;
+  int32_t   code  = 0;
+  int32_t   first = 0;
+  int32_t   index = 0;
+  uint8_t   len;
+
+  for (len = 1; len <= 15; len++) {
+    if (len > inf->bitCnt) return -1;
+    code |= bits & 1;
+    bits >>= 1;
+    if (code - (int32_t) count[len] < first) {
+      *codeLen = len;
+      return (int16_t) symbol[index + (code - first)];
+    }
+    index += count[len];
+    first += count[len];
+    first <<= 1;
+    code <<= 1;
+  }
+  return -2;
+}
+
+
+/*
+ * return 0 for complete code, positive for incomplete, negative for over-subscribed
+ */
+static int16_t build(uint16_t *count, uint16_t *symbol, const uint8_t *length, uint16_t n)
+{
+  uint16_t  offs[16];
+  int16_t   left = 1;
+  uint16_t  i;
+
+  memset(count, 0, 16 * sizeof(uint16_t));
+  for (i = 0; i < n; i++) count[length[i]]++;
+  if (count[0] == n) return 0;
+
+  for (i = 1; i < 16; i++) {
+    left <<= 1;
+    left -= (int16_t) count[i];
+    if (left < 0) return left;
+  }
+
+  offs[1] = 0;
+  for (i = 1; i < 15; i++) offs[i+1] = offs[i] + count[i];
+  for (i = 0; i < n; i++) {
+    if (length[i] != 0) symbol[offs[length[i]]++] = i;
+  }
+  return left;
+}
+
+
+static void buildFixed(QTEL_Inflate_t *inf)
+{
+  uint16_t i;
+
+  for (i = 0; i < 144; i++) inf->lengths[i] = 8;
+  for (; i < 256; i++)      inf->lengths[i] = 9;
+  for (; i < 280; i++)      inf->lengths[i] = 7;
+  for (; i < 288; i++)      inf->lengths[i] = 8;
+  build(inf->litCount, inf->litSymbol, inf->lengths, 288);
+
+  for (i = 0; i < 30; i++) inf->lengths[i] = 5;
+  build(inf->distCount, inf->distSymbol, inf->lengths, 30);
+}
+
+
+static void putByte(QTEL_Inflate_t *inf, uint8_t b)
+{
+  inf->window[inf->windowPos++] = b;
+  inf->total++;
+  if (inf->windowPos == QTEL_INFLATE_WINDOW_SIZE) {
+    flush(inf);
+    inf->windowPos = 0;
+    inf->flushPos = 0;
+  }
+}
+
+
+static void flush(QTEL_Inflate_t *inf)
+{
+  uint16_t length = inf->windowPos - inf->flushPos;
+
+  if (length == 0) return;
+
+  if (inf->format == QTEL_INFLATE_FORMAT_GZIP)
+    inf->crc = QTEL_CRC32_Update(inf->crc, &inf->window[inf->flushPos], length);
+  else if (inf->format == QTEL_INFLATE_FORMAT_ZLIB)
+    inf->crc = QTEL_Adler32_Update(inf->crc, &inf->window[inf->flushPos], length);
+  if (inf->onOutput != NULL)
+    inf->onOutput(inf->ctx, &inf->window[inf->flushPos], length);
+  inf->flushPos = inf->windowPos;
+}
+
+#endif /* QTEL_EN_FEATURE_INFLATE */
@@ -9,6 +9,7 @@
 #include "../include/quectel.h"
 #include "../include/quectel/net.h"
 #include "../include/quectel/socket.h"
+#include "../include/quectel/ssl.h"
 #include "../include/quectel/utils.h"
 #include "../include/quectel/debug.h"
 #include <stdlib.h>
@@ -122,6 +123,9 @@ void QTEL_NET_HandleEvents(QTEL_HandlerTypeDef *hqtel)
 
   if (QTEL_BITS_IS(hqtel->net.events, QTEL_NET_EVENT_ON_NTP_WAS_SYNCED)) {
     QTEL_BITS_UNSET(hqtel->net.events, QTEL_NET_EVENT_ON_NTP_WAS_SYNCED);
+    #if QTEL_EN_FEATURE_SSL
+    QTEL_SSL_OnClockSynced(hqtel);
+    #endif
     if (hqtel->NTP.onSynced != 0) {
       hqtel->NTP.onSynced(QTEL_GetTime(hqtel));
     }
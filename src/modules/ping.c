@@ -0,0 +1,223 @@
+/*
+ * ping.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/net.h"
+#include "../include/quectel/ping.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_PING
+
+static void addSample(QTEL_HandlerTypeDef*, uint16_t rtt);
+static void finishProbe(QTEL_HandlerTypeDef*);
+
+
+/*
+ * +QPING: <result>[,<IP_address>,<bytes>,<time>,<ttl>]            each echo
+ * +QPING: <finresult>[,<sent>,<rcvd>,<lost>,<min>,<max>,<avg>]    summary
+ */
+uint8_t QTEL_PING_CheckAsyncResponse(QTEL_HandlerTypeDef *hqtel)
+{
+  uint8_t       isGet   = 0;
+  char          *strTmp = (char*) &hqtel->respTmp[0];
+  const uint8_t *nextBuf;
+  uint16_t      result;
+
+  if ((isGet = (hqtel->respBufferLen > 8 && QTEL_IsResponse(hqtel, "+QPING: ", 8)))) {
+    if (!QTEL_BITS_IS(hqtel->net.ping.status, QTEL_PING_STATUS_PROBING)) return isGet;
+
+    memset(strTmp, 0, 6);
+    nextBuf = QTEL_ParseStr(&hqtel->respBuffer[8], ',', 0, (uint8_t*) strTmp);
+    result = (uint16_t) atoi(strTmp);
+
+    if (hqtel->net.ping.echoLeft == 0) {
+      // summary or error of the whole probe
+      finishProbe(hqtel);
+      return isGet;
+    }
+    if (result != 0 && *nextBuf != '\"') {
+      // error without reply fields ends the whole probe, no more echo follows
+      while (hqtel->net.ping.echoLeft) {
+        hqtel->net.ping.echoLeft--;
+        addSample(hqtel, QTEL_PING_LOST);
+      }
+      finishProbe(hqtel);
+      return isGet;
+    }
+    hqtel->net.ping.echoLeft--;
+
+    if (result == 0 && *nextBuf == '\"') {
+      // skip IP address and bytes, read time
+      memset(strTmp, 0, 6);
+      QTEL_ParseStr(nextBuf, ',', 2, (uint8_t*) strTmp);
+      addSample(hqtel, (uint16_t) atoi(strTmp));
+    }
+    else addSample(hqtel, QTEL_PING_LOST);
+  }
+
+  return isGet;
+}
+
+
+void QTEL_PING_HandleEvents(QTEL_HandlerTypeDef *hqtel)
+{
+  if (QTEL_BITS_IS(hqtel->net.ping.status, QTEL_PING_STATUS_PROBING)) {
+    if (QTEL_IsTimeout(hqtel->net.ping.tick, hqtel->net.ping.timeout)) {
+      // echo without response are counted as lost
+      while (hqtel->net.ping.echoLeft) {
+        hqtel->net.ping.echoLeft--;
+        addSample(hqtel, QTEL_PING_LOST);
+      }
+      finishProbe(hqtel);
+    }
+  }
+
+  else if (hqtel->net.ping.interval != 0
+           && hqtel->net.ping.host != NULL
+           && QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)
+           && QTEL_IsTimeout(hqtel->net.ping.tick, hqtel->net.ping.interval))
+  {
+    QTEL_CheckSignal(hqtel);
+    if (QTEL_PING_Probe(hqtel, hqtel->net.ping.host, hqtel->net.ping.count) != QTEL_OK)
+      hqtel->net.ping.tick = QTEL_GetTick();
+  }
+
+  if (QTEL_BITS_IS(hqtel->net.ping.events, QTEL_PING_EVENT_ON_PROBED)) {
+    QTEL_BITS_UNSET(hqtel->net.ping.events, QTEL_PING_EVENT_ON_PROBED);
+    if (hqtel->net.ping.onProbed != NULL)
+      hqtel->net.ping.onProbed();
+  }
+}
+
+
+/**
+ * send echo requests in background, results are collected from URC
+ */
+QTEL_Status_t QTEL_PING_Probe(QTEL_HandlerTypeDef *hqtel, const char *host, uint8_t count)
+{
+  QTEL_Status_t status = QTEL_ERROR;
+
+  if (QTEL_BITS_IS(hqtel->net.ping.status, QTEL_PING_STATUS_PROBING)) return QTEL_BUSY;
+  if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) return QTEL_ERROR;
+  if (count == 0) count = 1;
+  if (count > 10) count = 10;
+
+  QTEL_LOCK(hqtel);
+
+  hqtel->net.ping.tick = QTEL_GetTick();
+  QTEL_SendCMD(hqtel, "AT+QPING=%d,\"%s\",%d,%d",
+               (int) hqtel->net.contextId, host, QTEL_PING_TIMEOUT, (int) count);
+  if (!QTEL_IsResponseOK(hqtel)) goto endcmd;
+
+  hqtel->net.ping.echoLeft = count;
+  hqtel->net.ping.timeout = (uint32_t) QTEL_PING_TIMEOUT * 1000 * count + 5000;
+  QTEL_BITS_SET(hqtel->net.ping.status, QTEL_PING_STATUS_PROBING);
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+/**
+ * probe host periodically, interval 0 to stop
+ */
+void QTEL_PING_Schedule(QTEL_HandlerTypeDef *hqtel, const char *host, uint32_t interval, uint8_t count)
+{
+  hqtel->net.ping.host = host;
+  hqtel->net.ping.interval = interval;
+  hqtel->net.ping.count = count;
+}
+
+
+void QTEL_PING_GetStats(QTEL_HandlerTypeDef *hqtel, QTEL_Ping_Stats_t *stats)
+{
+  uint16_t  sorted[QTEL_PING_NUM_OF_SAMPLES];
+  uint16_t  rtt;
+  uint32_t  total = 0;
+  uint8_t   received = 0;
+  uint8_t   i, j;
+
+  memset(stats, 0, sizeof(QTEL_Ping_Stats_t));
+  stats->sampleNum = hqtel->net.ping.sampleNum;
+  if (stats->sampleNum == 0) return;
+
+  // insertion sort of received samples for percentile
+  for (i = 0; i < stats->sampleNum; i++) {
+    rtt = hqtel->net.ping.samples[i];
+    if (rtt == QTEL_PING_LOST) continue;
+    total += rtt;
+    for (j = received; j > 0 && sorted[j-1] > rtt; j--) {
+      sorted[j] = sorted[j-1];
+    }
+    sorted[j] = rtt;
+    received++;
+  }
+
+  stats->loss = (uint8_t) ((uint16_t) (stats->sampleNum - received) * 100 / stats->sampleNum);
+  if (received == 0) return;
+
+  stats->min = sorted[0];
+  stats->max = sorted[received-1];
+  stats->avg = (uint16_t) (total / received);
+  stats->p95 = sorted[((uint16_t) received * 95 + 99) / 100 - 1];
+}
+
+
+void QTEL_PING_Reset(QTEL_HandlerTypeDef *hqtel)
+{
+  hqtel->net.ping.sampleIdx = 0;
+  hqtel->net.ping.sampleNum = 0;
+}
+
+
+/**
+ * link quality 0-100 from signal strength, latency and loss,
+ * only the signal is used while there is no sample
+ */
+uint8_t QTEL_PING_GetLinkQuality(QTEL_HandlerTypeDef *hqtel)
+{
+  QTEL_Ping_Stats_t stats;
+  uint16_t          signalScore;
+  uint16_t          rttScore;
+
+  signalScore = (hqtel->signal > 31) ? 0 : ((uint16_t) hqtel->signal * 100 / 31);
+
+  QTEL_PING_GetStats(hqtel, &stats);
+  if (stats.sampleNum == 0) return (uint8_t) signalScore;
+  if (stats.loss == 100) return 0;
+
+  if (stats.p95 <= QTEL_PING_RTT_GOOD)      rttScore = 100;
+  else if (stats.p95 >= QTEL_PING_RTT_BAD)  rttScore = 0;
+  else rttScore = (uint16_t) ((uint32_t) (QTEL_PING_RTT_BAD - stats.p95) * 100
+                              / (QTEL_PING_RTT_BAD - QTEL_PING_RTT_GOOD));
+
+  return (uint8_t) ((signalScore * 30 + rttScore * 30 + (100 - stats.loss) * 40) / 100);
+}
+
+
+static void addSample(QTEL_HandlerTypeDef *hqtel, uint16_t rtt)
+{
+  hqtel->net.ping.samples[hqtel->net.ping.sampleIdx] = rtt;
+  hqtel->net.ping.sampleIdx = (hqtel->net.ping.sampleIdx + 1) % QTEL_PING_NUM_OF_SAMPLES;
+  if (hqtel->net.ping.sampleNum < QTEL_PING_NUM_OF_SAMPLES)
+    hqtel->net.ping.sampleNum++;
+}
+
+
+static void finishProbe(QTEL_HandlerTypeDef *hqtel)
+{
+  hqtel->net.ping.echoLeft = 0;
+  QTEL_BITS_UNSET(hqtel->net.ping.status, QTEL_PING_STATUS_PROBING);
+  QTEL_BITS_SET(hqtel->net.ping.events, QTEL_PING_EVENT_ON_PROBED);
+}
+
+#endif /* QTEL_EN_FEATURE_PING */
@@ -0,0 +1,345 @@
+/*
+ * sockapi.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/net.h"
+#include "../include/quectel/socket.h"
+#include "../include/quectel/sockapi.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <string.h>
+
+#if QTEL_EN_FEATURE_SOCKET && QTEL_EN_FEATURE_SOCKAPI
+
+static QTEL_BSD_Desc_t descriptors[QTEL_SOCKAPI_NUM_OF_FD];
+
+static QTEL_BSD_Desc_t* getDesc(int fd);
+static uint8_t          getReadyEvents(QTEL_BSD_Desc_t*);
+static uint16_t         getRecvAvailable(QTEL_Socket_t*);
+static uint8_t          isConnected(QTEL_BSD_Desc_t*);
+static void             releaseLink(QTEL_Socket_t*);
+static void             onRxDropped(QTEL_Socket_t*);
+
+
+int QTEL_BSD_Socket(QTEL_HandlerTypeDef *hqtel, uint8_t type)
+{
+  QTEL_BSD_Desc_t *desc;
+  int fd;
+
+  if (type != QTEL_SOCK_TCPIP
+      #if QTEL_EN_FEATURE_SSL
+      && type != QTEL_SOCK_SSL
+      #endif
+  ) {
+    return -QTEL_BSD_EINVAL;
+  }
+
+  for (fd = 0; fd < QTEL_SOCKAPI_NUM_OF_FD; fd++) {
+    if (!descriptors[fd].isUsed) break;
+  }
+  if (fd >= QTEL_SOCKAPI_NUM_OF_FD) return -QTEL_BSD_ENOMEM;
+
+  desc = &descriptors[fd];
+  memset(desc, 0, sizeof(QTEL_BSD_Desc_t));
+  desc->isUsed = 1;
+  desc->timeout = QTEL_SOCK_DEFAULT_TO;
+  desc->socket.hqtel = hqtel;
+  desc->socket.linkNum = -1;
+  desc->socket.type = type;
+  desc->socket.listeners.onRxDropped = onRxDropped;
+  QTEL_SOCK_SetSpanBuffer(&desc->socket, desc->rxBuffer, sizeof(desc->rxBuffer));
+
+  return fd;
+}
+
+
+int QTEL_BSD_SetNonBlocking(int fd, uint8_t enable)
+{
+  QTEL_BSD_Desc_t *desc = getDesc(fd);
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  desc->isNonBlocking = enable;
+  return 0;
+}
+
+
+int QTEL_BSD_SetTimeout(int fd, uint32_t timeout)
+{
+  QTEL_BSD_Desc_t *desc = getDesc(fd);
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  desc->timeout = timeout;
+  return 0;
+}
+
+
+#if QTEL_EN_FEATURE_SSL
+int QTEL_BSD_SetSSLContext(int fd, uint8_t sslCtxId)
+{
+  QTEL_BSD_Desc_t *desc = getDesc(fd);
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  if (desc->socket.type != QTEL_SOCK_SSL) return -QTEL_BSD_EINVAL;
+  desc->socket.config.sslCtxId = sslCtxId;
+  return 0;
+}
+#endif /* QTEL_EN_FEATURE_SSL */
+
+
+/**
+ * return 0 when connected, -QTEL_BSD_EINPROGRESS on non blocking socket
+ * then wait for QTEL_BSD_POLLOUT
+ */
+int QTEL_BSD_Connect(int fd, const char *host, uint16_t port)
+{
+  QTEL_BSD_Desc_t     *desc = getDesc(fd);
+  QTEL_HandlerTypeDef *hqtel;
+  QTEL_Socket_t       *sock;
+  uint32_t            tick;
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  sock = &desc->socket;
+  hqtel = sock->hqtel;
+
+  if (QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN)) return -QTEL_BSD_EISCONN;
+  if (QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPENING)) return -QTEL_BSD_EALREADY;
+  if (strlen(host) >= sizeof(sock->host)) return -QTEL_BSD_EINVAL;
+
+  sock->config.timeout = desc->timeout;
+  desc->isConnected = 0;
+  desc->isRxDropped = 0;
+  QTEL_SOCK_ResetStats(sock);
+  if (QTEL_SOCK_Init(sock, host, port) != QTEL_OK) return -QTEL_BSD_EINVAL;
+  if (QTEL_SOCK_Open(sock, hqtel) != QTEL_OK) return -QTEL_BSD_ECONNREFUSED;
+
+  if (desc->isNonBlocking) return -QTEL_BSD_EINPROGRESS;
+
+  tick = QTEL_GetTick();
+  while (QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPENING)) {
+    if (QTEL_IsTimeout(tick, QTEL_SOCKAPI_CONNECT_TO)) {
+      QTEL_SOCK_Close(sock);
+      releaseLink(sock);
+      return -QTEL_BSD_ETIMEDOUT;
+    }
+    QTEL_BSD_Wait(hqtel);
+  }
+
+  if (!QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN)) {
+    releaseLink(sock);
+    return -QTEL_BSD_ECONNREFUSED;
+  }
+  desc->isConnected = 1;
+  return 0;
+}
+
+
+/**
+ * return length of sent data, sending is always blocking
+ * because the modem takes the data synchronously
+ */
+int32_t QTEL_BSD_Send(int fd, const void *data, uint32_t length)
+{
+  QTEL_BSD_Desc_t   *desc = getDesc(fd);
+  QTEL_Sock_Span_t  span;
+  uint32_t          sentLen;
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  if (!QTEL_SOCK_IS_STATE(&desc->socket, QTEL_SOCK_STATE_OPEN))
+    return isConnected(desc) ? -QTEL_BSD_EPIPE : -QTEL_BSD_ENOTCONN;
+  if (length == 0) return 0;
+
+  span.data = (const uint8_t*) data;
+  span.length = length;
+  sentLen = QTEL_SockSendSpans(desc->socket.hqtel, desc->socket.linkNum, &span, 1, NULL, NULL);
+  if (sentLen == 0) return -QTEL_BSD_EIO;
+  return (int32_t) sentLen;
+}
+
+
+/**
+ * return length of read data, 0 when the connection was closed,
+ * -QTEL_BSD_EAGAIN on non blocking socket without data
+ * or -QTEL_BSD_EIO when received data was lost
+ */
+int32_t QTEL_BSD_Recv(int fd, void *buffer, uint16_t length)
+{
+  QTEL_BSD_Desc_t   *desc = getDesc(fd);
+  QTEL_Socket_t     *sock;
+  QTEL_Sock_Span_t  spans[2];
+  uint8_t           spanNum;
+  uint16_t          readLen = 0;
+  uint16_t          copyLen;
+  uint32_t          tick;
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  sock = &desc->socket;
+  if (desc->isRxDropped) return -QTEL_BSD_EIO;
+
+  tick = QTEL_GetTick();
+  while (getRecvAvailable(sock) == 0) {
+    if (!QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN))
+      return isConnected(desc) ? 0 : -QTEL_BSD_ENOTCONN;
+    if (desc->isNonBlocking) return -QTEL_BSD_EAGAIN;
+    if (QTEL_IsTimeout(tick, desc->timeout)) return -QTEL_BSD_EAGAIN;
+    QTEL_BSD_Wait(sock->hqtel);
+  }
+
+  spanNum = QTEL_SOCK_PeekSpans(sock, spans);
+  for (uint8_t i = 0; i < spanNum && readLen < length; i++) {
+    copyLen = length - readLen;
+    if (copyLen > spans[i].length) copyLen = spans[i].length;
+    memcpy((uint8_t*) buffer + readLen, spans[i].data, copyLen);
+    readLen += copyLen;
+  }
+  QTEL_SOCK_Consume(sock, readLen);
+
+  return readLen;
+}
+
+
+int QTEL_BSD_Close(int fd)
+{
+  QTEL_BSD_Desc_t *desc = getDesc(fd);
+  QTEL_Socket_t   *sock;
+
+  if (desc == NULL) return -QTEL_BSD_EBADF;
+  sock = &desc->socket;
+
+  if (sock->linkNum >= 0 && !QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_CLOSED))
+    QTEL_SOCK_Close(sock);
+  releaseLink(sock);
+
+  desc->isUsed = 0;
+  return 0;
+}
+
+
+/**
+ * wait until any requested event is ready, timeout -1 for infinite,
+ * return number of ready descriptors or 0 when timeout
+ */
+int QTEL_BSD_Poll(QTEL_BSD_PollFd_t *fds, uint8_t nfds, int32_t timeout)
+{
+  QTEL_BSD_Desc_t     *desc;
+  QTEL_HandlerTypeDef *hqtel = NULL;
+  uint32_t            tick = QTEL_GetTick();
+  int                 readyNum;
+  uint8_t             i;
+
+  while (1) {
+    readyNum = 0;
+    for (i = 0; i < nfds; i++) {
+      desc = getDesc(fds[i].fd);
+      if (desc == NULL) {
+        fds[i].revents = QTEL_BSD_POLLERR;
+      } else {
+        hqtel = desc->socket.hqtel;
+        // error and hang up are always reported
+        fds[i].revents = getReadyEvents(desc)
+                         & (fds[i].events | QTEL_BSD_POLLERR | QTEL_BSD_POLLHUP);
+      }
+      if (fds[i].revents) readyNum++;
+    }
+
+    if (readyNum > 0) return readyNum;
+    if (timeout >= 0 && QTEL_IsTimeout(tick, (uint32_t) timeout)) return 0;
+    if (hqtel == NULL) QTEL_Delay(1);
+    else QTEL_BSD_Wait(hqtel);
+  }
+}
+
+
+/*
+ * called while blocking, without RTOS lock nothing else is running
+ * the handler so the responses are read here,
+ * override it to yield to the scheduler
+ */
+__attribute__((weak)) void QTEL_BSD_Wait(QTEL_HandlerTypeDef *hqtel)
+{
+  if (hqtel->lock == NULL) QTEL_CheckAnyResponse(hqtel);
+  else QTEL_Delay(1);
+}
+
+
+static QTEL_BSD_Desc_t* getDesc(int fd)
+{
+  if (fd < 0 || fd >= QTEL_SOCKAPI_NUM_OF_FD) return NULL;
+  if (!descriptors[fd].isUsed) return NULL;
+  return &descriptors[fd];
+}
+
+
+static uint8_t getReadyEvents(QTEL_BSD_Desc_t *desc)
+{
+  QTEL_Socket_t *sock = &desc->socket;
+  uint8_t       events = 0;
+
+  if (QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN)) {
+    events |= QTEL_BSD_POLLOUT;
+  }
+  else if (QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_CLOSED) && sock->linkNum >= 0) {
+    // remaining data can still be read after hang up
+    events |= isConnected(desc) ? (QTEL_BSD_POLLHUP | QTEL_BSD_POLLIN) : QTEL_BSD_POLLERR;
+  }
+
+  if (getRecvAvailable(sock) > 0) events |= QTEL_BSD_POLLIN;
+  if (desc->isRxDropped) events |= QTEL_BSD_POLLERR;
+
+  return events;
+}
+
+
+static uint16_t getRecvAvailable(QTEL_Socket_t *sock)
+{
+  QTEL_Sock_Span_t  spans[2];
+  uint8_t           spanNum;
+  uint16_t          length = 0;
+
+  spanNum = QTEL_SOCK_PeekSpans(sock, spans);
+  for (uint8_t i = 0; i < spanNum; i++) {
+    length += spans[i].length;
+  }
+  return length;
+}
+
+/*
+ * connection was opened since the last connect, even it was closed
+ * before the application polled it
+ */
+static uint8_t isConnected(QTEL_BSD_Desc_t *desc)
+{
+  if (QTEL_SOCK_IS_STATE(&desc->socket, QTEL_SOCK_STATE_OPEN)
+      || desc->socket.stats.connectedTime > 0)
+  {
+    desc->isConnected = 1;
+  }
+  return desc->isConnected;
+}
+
+
+/*
+ * remove socket from the handler table, only if the link is still held by it,
+ * so the descriptor can be reused before the closing event is handled
+ */
+static void releaseLink(QTEL_Socket_t *sock)
+{
+  if (sock->linkNum < 0 || sock->linkNum >= QTEL_NUM_OF_SOCKET) return;
+  if (sock->hqtel->net.sockets[sock->linkNum] == (void*) sock)
+    QTEL_SockRemoveListener(sock->hqtel, sock->linkNum);
+}
+
+
+/*
+ * the stream has a gap, keep the connection and let recv report it,
+ * socket is the first member of the descriptor
+ */
+static void onRxDropped(QTEL_Socket_t *sock)
+{
+  ((QTEL_BSD_Desc_t*) sock)->isRxDropped = 1;
+}
+
+#endif /* QTEL_EN_FEATURE_SOCKET && QTEL_EN_FEATURE_SOCKAPI */
@@ -10,6 +10,8 @@
 #include "../include/quectel.h"
 #include "../include/quectel/net.h"
 #include "../include/quectel/socket.h"
+#include "../include/quectel/ssl.h"
+#include "../include/quectel/dns.h"
 #include "../include/quectel/utils.h"
 #include "../include/quectel/debug.h"
 #include <stdio.h>
@@ -24,8 +26,33 @@
 // event handlers
 static QTEL_Status_t  setTCPDefaultConfiguration(QTEL_HandlerTypeDef*);
 static void           resetOpenedSocket(QTEL_HandlerTypeDef*);
+static uint8_t        closeListedSocket(QTEL_HandlerTypeDef*, const char *stateCmd, const char *closeCmd);
+static void           registerSocket(QTEL_HandlerTypeDef*, QTEL_Socket_t*);
+static void           unregisterSocket(QTEL_HandlerTypeDef*, uint8_t connId);
+static void           setSocketEvent(QTEL_HandlerTypeDef*, QTEL_Socket_t*, uint8_t event);
+static void           setSocketReconnect(QTEL_HandlerTypeDef*, QTEL_Socket_t*);
+static uint32_t       getReconnectDelay(QTEL_Socket_t*);
+static void           setLinkState(QTEL_HandlerTypeDef*, int8_t connId, uint8_t state);
+static void           setOpenResult(QTEL_HandlerTypeDef*, const uint8_t *resp);
+static void           setClosedByServer(QTEL_HandlerTypeDef*, const uint8_t *resp);
 static void           receiveData(QTEL_HandlerTypeDef*);
+static void           receiveKeptData(QTEL_Socket_t*);
+static void           acceptIncoming(QTEL_HandlerTypeDef*, const uint8_t *nextBuf);
 static QTEL_Status_t  sockOpen(QTEL_Socket_t*);
+static QTEL_Status_t  sockConnect(QTEL_Socket_t*, const char *host);
+static uint8_t        sendChunkStart(QTEL_HandlerTypeDef*, int8_t connId, uint16_t length);
+static uint8_t        sendChunkFinish(QTEL_HandlerTypeDef*);
+static void           sendChunkAbort(QTEL_HandlerTypeDef*, int8_t connId, uint16_t remainLen);
+static uint32_t       sendStream(QTEL_HandlerTypeDef*, int8_t connId, uint32_t length,
+                                 QTEL_Sock_Producer_Func, void *producerCtx,
+                                 QTEL_Sock_Progress_Func, void *progressCtx);
+static uint16_t       bufferProducer(void *ctx, uint8_t *dstBuf, uint16_t bufSz);
+static void           updateSendStats(QTEL_HandlerTypeDef*, int8_t connId, uint16_t length, uint32_t latency);
+static void           updateRecvStats(QTEL_HandlerTypeDef*, QTEL_Socket_t*, uint16_t length);
+static uint8_t        forwardRecvData(QTEL_HandlerTypeDef*, QTEL_Socket_t*, uint16_t length);
+static uint16_t       getRxSpace(QTEL_Socket_t*, uint8_t isContiguous);
+static uint8_t        getRxSpans(QTEL_Socket_t*, uint16_t from, uint16_t to, QTEL_Sock_Span_t spans[2]);
+static void           deliverRxSpans(QTEL_Socket_t*);
 
 static char* keyStr[QTEL_SOCK_CFG_KEYS_NUM] = {
   "transpktsize",
@@ -44,70 +71,80 @@ static char* keyStr[QTEL_SOCK_CFG_KEYS_NUM] = {
   "recvind",
 };
 
+#if QTEL_NUM_OF_SOCKET > QTEL_MAX_NUM_OF_SOCKET
+#error "QTEL_NUM_OF_SOCKET is more than the modem connections"
+#endif
+
+#define QTEL_SOCK_LINKS_MASK  ((uint16_t) ((1 << QTEL_NUM_OF_SOCKET) - 1))
+
+// find first free link from bitmap
 #define Get_Available_LinkNum(hqtel, connId) {\
-  for (int16_t i = 0; i < QTEL_NUM_OF_SOCKET && i < QTEL_MAX_NUM_OF_SOCKET; i++) {\
-    if ((hqtel)->net.sockets[i] == NULL) {\
-      *(connId) = i;\
-      break;\
-    }\
-  }\
+  uint16_t freeLinks = (uint16_t) ~(hqtel)->net.sockLinks & QTEL_SOCK_LINKS_MASK;\
+  if (freeLinks) *(connId) = (int8_t) __builtin_ctz(freeLinks);\
 }
 
 
 uint8_t QTEL_SockCheckAsyncResponse(QTEL_HandlerTypeDef *hqtel)
 {
   // uint8_t ctxId;
-  int8_t        connId;
-  QTEL_Socket_t *socket;
   uint8_t       isGet   = 0;
-  uint16_t      err;
   char          *strTmp = (char*) &hqtel->respTmp[0];
   const uint8_t *nextBuf;
+  #if QTEL_EN_FEATURE_SSL
+  int8_t        connId;
+  QTEL_Socket_t *socket;
+  #endif
 
   // handle URC
   if ((isGet = QTEL_IsResponse(hqtel, "+QIURC", 6))) {
-    memset(strTmp, 0, 6);
+    memset(strTmp, 0, 16);
     nextBuf = QTEL_ParseStr(&hqtel->respBuffer[8], ',', 0, (uint8_t*) strTmp);
-    if (strncmp(strTmp, "recv", 4) == 0) {
+    if (strcmp(strTmp, "recv") == 0) {
       receiveData(hqtel);
     }
-    else if (strncmp(strTmp, "closed", 6) == 0) {
-      memset(strTmp, 0, 3);
-      nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
-      connId = (int8_t) atoi(strTmp);
-      // int reason  =          atoi((char*)&(hqtel->respBuffer[12]));
-
-      socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
-      if (socket != NULL) {
-        QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR);
-        QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED);
-        QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
-      }
+    else if (strcmp(strTmp, "incoming") == 0) {
+      acceptIncoming(hqtel, nextBuf);
+    }
+    else if (strcmp(strTmp, "incoming full") == 0) {
+      // the modem refuses the client itself when all links are used
+    }
+    else if (strcmp(strTmp, "closed") == 0) {
+      setClosedByServer(hqtel, nextBuf);
     }
     else return 0;
   }
 
   else if ((isGet = (hqtel->respBufferLen >= 11 && QTEL_IsResponse(hqtel, "+QIOPEN", 7))))
   {
-    memset(strTmp, 0, 3);
-    nextBuf = QTEL_ParseStr(&hqtel->respBuffer[9], ',', 0, (uint8_t*) strTmp);
-    connId  = (uint16_t) atoi(strTmp);
+    setOpenResult(hqtel, &hqtel->respBuffer[9]);
+  }
 
-    memset(strTmp, 0, 4);
-    nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
-    err     = (uint16_t) atoi(strTmp);
+  #if QTEL_EN_FEATURE_SSL
+  else if ((isGet = (hqtel->respBufferLen >= 13 && QTEL_IsResponse(hqtel, "+QSSLOPEN", 9))))
+  {
+    setOpenResult(hqtel, &hqtel->respBuffer[11]);
+  }
 
-    socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
-    if (socket != NULL) {
-      if (err == 0) {
-        QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_OPENED);
-        QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_OPEN);
-      } else {
-        QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_OPENING_ERROR);
-        QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
+  else if ((isGet = QTEL_IsResponse(hqtel, "+QSSLURC", 8))) {
+    memset(strTmp, 0, 10);
+    nextBuf = QTEL_ParseStr(&hqtel->respBuffer[10], ',', 0, (uint8_t*) strTmp);
+    if (strncmp(strTmp, "recv", 4) == 0) {
+      // data is kept by the modem, read it later with AT+QSSLRECV
+      memset(strTmp, 0, 3);
+      QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+      connId = (int8_t) atoi(strTmp);
+      if (connId >= 0 && connId < QTEL_NUM_OF_SOCKET
+          && (socket = (QTEL_Socket_t*) hqtel->net.sockets[connId]) != NULL)
+      {
+        setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_RECV_PENDING);
       }
     }
+    else if (strncmp(strTmp, "closed", 6) == 0) {
+      setClosedByServer(hqtel, nextBuf);
+    }
+    else return 0;
   }
+  #endif /* QTEL_EN_FEATURE_SSL */
 
   return isGet;
 }
@@ -116,53 +153,120 @@ uint8_t QTEL_SockCheckAsyncResponse(QTEL_HandlerTypeDef *hqtel)
 void QTEL_SockHandleEvents(QTEL_HandlerTypeDef *hqtel)
 {
   int16_t       i;
+  uint16_t      links;
   QTEL_Socket_t *socket;
+  #if QTEL_EN_FEATURE_DNS
+  char          ip[QTEL_DNS_IP_SIZE];
+  #endif
+
+  // close connection which is not held by any socket
+  for (i = 0; hqtel->net.sockCloseReqs && i < QTEL_MAX_NUM_OF_SOCKET; i++) {
+    if (QTEL_BITS_IS(hqtel->net.sockCloseReqs, (1 << i))) {
+      QTEL_BITS_UNSET(hqtel->net.sockCloseReqs, (1 << i));
+      QTEL_SockClose(hqtel, i);
+    }
+  }
 
-  // Socket Event Handler
-  for (i = 0; QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN) && i < QTEL_NUM_OF_SOCKET; i++)
-  {
-    if ((socket = hqtel->net.sockets[i]) != NULL) {
-      if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_OPENED)) {
-        QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_OPENED);
-        if (socket->listeners.onConnected != NULL)
-          socket->listeners.onConnected();
-      }
+  if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) return;
+
+  // Socket Event Handler, only visit link which has events
+  links = hqtel->net.sockEvents;
+  hqtel->net.sockEvents = 0;
+  while (links) {
+    i = __builtin_ctz(links);
+    QTEL_BITS_UNSET(links, (1 << i));
+
+    if ((socket = hqtel->net.sockets[i]) == NULL) continue;
 
-      if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_OPENING_ERROR)) {
-        QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_OPENING_ERROR);
-        if (socket->config.autoReconnect) {
-          socket->tick.reconnDelay = QTEL_GetTick();
-          if (socket->listeners.onConnectError != NULL)
-            socket->listeners.onConnectError();
+    #if QTEL_EN_FEATURE_DNS
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_RESOLVED)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_RESOLVED);
+      if (QTEL_SOCK_IS_STATE(socket, QTEL_SOCK_STATE_OPENING)) {
+        socket->latency.dns = QTEL_DNS_GetResolveTime(hqtel, socket->host);
+        if (QTEL_DNS_Lookup(hqtel, socket->host, ip) == QTEL_OK) {
+          sockConnect(socket, ip);
+        } else {
+          socket->error = QTEL_DNS_GetError(hqtel, socket->host);
+          QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
+          QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_OPENING_ERROR);
         }
       }
+    }
+    #endif
 
-      if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR)) {
-        QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR);
-        QTEL_SOCK_Close(socket);
-      }
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_OPENED)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_OPENED);
+      if (socket->listeners.onConnected != NULL)
+        socket->listeners.onConnected();
+    }
 
-      if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_CLOSED)) {
-        QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED);
-        if (!socket->config.autoReconnect)
-          hqtel->net.sockets[i] = NULL;
-        else socket->tick.reconnDelay = QTEL_GetTick();
-        if (socket->listeners.onClosed != NULL)
-          socket->listeners.onClosed();
-      }
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_OPENING_ERROR)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_OPENING_ERROR);
+      if (socket->config.autoReconnect)
+        setSocketReconnect(hqtel, socket);
+      else unregisterSocket(hqtel, i);
+      if (socket->listeners.onConnectError != NULL)
+        socket->listeners.onConnectError();
+    }
 
-      if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_RECEIVED)) {
-        QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_RECEIVED);
-        if (socket->listeners.onReceived != NULL)
-          socket->listeners.onReceived(&(socket->buffer));
-      }
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR);
+      QTEL_SOCK_Close(socket);
+    }
 
-      // auto reconnect
-      if (QTEL_SOCK_IS_STATE(socket, QTEL_SOCK_STATE_CLOSED)) {
-        if (QTEL_IsTimeout(socket->tick.reconnDelay, socket->config.reconnectingDelay)) {
-          sockOpen(socket);
-        }
-      }
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_CLOSED)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED);
+      if (!socket->config.autoReconnect)
+        unregisterSocket(hqtel, i);
+      else setSocketReconnect(hqtel, socket);
+      if (socket->listeners.onClosed != NULL)
+        socket->listeners.onClosed();
+    }
+
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_RECV_PENDING)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_RECV_PENDING);
+      receiveKeptData(socket);
+    }
+
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_RECEIVED)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_RECEIVED);
+      if (socket->rx.buffer != NULL)
+        deliverRxSpans(socket);
+      else if (socket->listeners.onReceived != NULL)
+        socket->listeners.onReceived(&(socket->buffer));
+    }
+
+    // the stream has a gap, it can't be used further without the owner
+    if (QTEL_BITS_IS(socket->events, QTEL_SOCK_EVENT_ON_RX_DROPPED)) {
+      QTEL_BITS_UNSET(socket->events, QTEL_SOCK_EVENT_ON_RX_DROPPED);
+      if (socket->listeners.onRxDropped != NULL)
+        socket->listeners.onRxDropped(socket);
+      else
+        QTEL_SOCK_Close(socket);
+    }
+  }
+
+  // auto reconnect
+  links = hqtel->net.sockReconnects;
+  while (links) {
+    i = __builtin_ctz(links);
+    QTEL_BITS_UNSET(links, (1 << i));
+
+    socket = hqtel->net.sockets[i];
+    if (socket == NULL
+        || !socket->config.autoReconnect
+        || !QTEL_SOCK_IS_STATE(socket, QTEL_SOCK_STATE_CLOSED))
+    {
+      QTEL_BITS_UNSET(hqtel->net.sockReconnects, (1 << i));
+      continue;
+    }
+
+    if (QTEL_IsTimeout(socket->tick.reconnDelay, socket->reconnect.delay)) {
+      QTEL_BITS_UNSET(hqtel->net.sockReconnects, (1 << i));
+      socket->reconnect.count++;
+      socket->stats.reconnects++;
+      hqtel->net.sockStats.reconnects++;
+      sockOpen(socket);
     }
   }
 }
@@ -171,33 +275,66 @@ void QTEL_SockHandleEvents(QTEL_HandlerTypeDef *hqtel)
 void QTEL_SockOnStarted(QTEL_HandlerTypeDef *hqtel)
 {
   QTEL_Socket_t *socket;
+  uint16_t      links = hqtel->net.sockLinks;
+  uint8_t       i;
+
+  while (links) {
+    i = __builtin_ctz(links);
+    QTEL_BITS_UNSET(links, (1 << i));
 
-  for (uint8_t i = 0; i < QTEL_NUM_OF_SOCKET; i++) {
     if ((socket = hqtel->net.sockets[i]) != NULL) {
       if (QTEL_SOCK_IS_STATE(socket, QTEL_SOCK_STATE_OPENING)) {
-        if (socket->config.autoReconnect) {
-          socket->tick.reconnDelay = QTEL_GetTick();
-          if (socket->listeners.onConnectError != NULL)
-            socket->listeners.onConnectError();
-        }
+        if (!socket->config.autoReconnect)
+          unregisterSocket(hqtel, i);
+        if (socket->listeners.onConnectError != NULL)
+          socket->listeners.onConnectError();
       }
 
       else if (QTEL_SOCK_IS_STATE(socket, QTEL_SOCK_STATE_OPEN)) {
         if (!socket->config.autoReconnect)
-          hqtel->net.sockets[i] = NULL;
+          unregisterSocket(hqtel, i);
         if (socket->listeners.onClosed != NULL)
           socket->listeners.onClosed();
       }
-      QTEL_SOCK_SET_STATE(socket, 0);
+      QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
+      if (socket->config.autoReconnect)
+        setSocketReconnect(hqtel, socket);
     }
   }
 }
 
 
+#if QTEL_EN_FEATURE_DNS
+/*
+ * continue opening sockets which were waiting for host address
+ */
+void QTEL_SockOnResolved(QTEL_HandlerTypeDef *hqtel, const char *host)
+{
+  QTEL_Socket_t *socket;
+  uint16_t      links = hqtel->net.sockResolving;
+  uint8_t       i;
+
+  while (links) {
+    i = __builtin_ctz(links);
+    QTEL_BITS_UNSET(links, (1 << i));
+
+    socket = hqtel->net.sockets[i];
+    if (socket == NULL || strcmp(socket->host, host) != 0) continue;
+
+    QTEL_BITS_UNSET(hqtel->net.sockResolving, (1 << i));
+    setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_RESOLVED);
+  }
+}
+#endif /* QTEL_EN_FEATURE_DNS */
+
+
 void QTEL_SockOnNetOpened(QTEL_HandlerTypeDef *hqtel)
 {
   setTCPDefaultConfiguration(hqtel);
   resetOpenedSocket(hqtel);
+  #if QTEL_EN_FEATURE_SSL
+  QTEL_SSL_OnNetOpened(hqtel);
+  #endif
 }
 
 
@@ -238,10 +375,14 @@ QTEL_Status_t QTEL_SockConfig(QTEL_HandlerTypeDef *hqtel, QTEL_Sock_ConfigKey_t
 /**
  * return linknum if connected
  * return -1 if not connected
+ * socket with span buffer is opened in buffer access mode, its data is kept
+ * by the modem until there is space and read by AT+QIRD, others are pushed
  */
 QTEL_Status_t QTEL_SockOpenTCPIP(QTEL_HandlerTypeDef *hqtel, int8_t *connId, const char *host, uint16_t port)
 {
   QTEL_Status_t status = QTEL_ERROR;
+  QTEL_Socket_t *socket;
+  uint8_t       accessMode = 1;
 
   if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN) || !QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_AVAILABLE))
   {
@@ -253,15 +394,56 @@ QTEL_Status_t QTEL_SockOpenTCPIP(QTEL_HandlerTypeDef *hqtel, int8_t *connId, con
     if (*connId == -1) return QTEL_ERROR;
   }
 
+  socket = (QTEL_Socket_t*) hqtel->net.sockets[*connId];
+  if (socket != NULL && socket->rx.buffer != NULL) accessMode = 0;
+
   QTEL_LOCK(hqtel);
   QTEL_SendCMD(hqtel, 
-               "AT+QIOPEN=%u,%d,\"TCP\",\"%s\",%d,0,1", 
-               (uint) hqtel->net.contextId, (uint) *connId, host, port);
+               "AT+QIOPEN=%u,%d,\"TCP\",\"%s\",%d,0,%u", 
+               (uint) hqtel->net.contextId, (uint) *connId, host, port, (uint) accessMode);
+
+  setLinkState(hqtel, *connId, QTEL_SOCK_STATE_OPENING);
+
+  if (!QTEL_IsResponseOK(hqtel)) {
+    setLinkState(hqtel, *connId, QTEL_SOCK_STATE_CLOSED);
+    goto endcmd;
+  }
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+/**
+ * listen on localPort, incoming client will be accepted by the modem
+ * into another link number (tcp/accept was enabled), accepted links inherit
+ * buffer access mode and their data is read by AT+QIRD
+ */
+QTEL_Status_t QTEL_SockOpenTCPListener(QTEL_HandlerTypeDef *hqtel, int8_t *connId, uint16_t localPort)
+{
+  QTEL_Status_t status = QTEL_ERROR;
+
+  if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN) || !QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_AVAILABLE))
+  {
+    return QTEL_ERROR;
+  }
+
+  if (*connId == -1 || hqtel->net.sockets[*connId] == NULL) {
+    Get_Available_LinkNum(hqtel, connId);
+    if (*connId == -1) return QTEL_ERROR;
+  }
 
-  QTEL_SOCK_SET_STATE((QTEL_Socket_t*)hqtel->net.sockets[*connId], QTEL_SOCK_STATE_OPENING);
+  QTEL_LOCK(hqtel);
+  QTEL_SendCMD(hqtel,
+               "AT+QIOPEN=%u,%d,\"TCP LISTENER\",\"127.0.0.1\",0,%d,0",
+               (uint) hqtel->net.contextId, (uint) *connId, localPort);
+
+  setLinkState(hqtel, *connId, QTEL_SOCK_STATE_OPENING);
 
   if (!QTEL_IsResponseOK(hqtel)) {
-    QTEL_SOCK_SET_STATE((QTEL_Socket_t*)hqtel->net.sockets[*connId], QTEL_SOCK_STATE_CLOSED);
+    setLinkState(hqtel, *connId, QTEL_SOCK_STATE_CLOSED);
     goto endcmd;
   }
   status = QTEL_OK;
@@ -272,22 +454,67 @@ QTEL_Status_t QTEL_SockOpenTCPIP(QTEL_HandlerTypeDef *hqtel, int8_t *connId, con
 }
 
 
+#if QTEL_EN_FEATURE_SSL
+/**
+ * open SSL client with configured SSL context (see QTEL_SSL_SetupContext),
+ * data is read from the modem buffer by AT+QSSLRECV
+ */
+QTEL_Status_t QTEL_SockOpenSSL(QTEL_HandlerTypeDef *hqtel, int8_t *connId, uint8_t sslCtxId,
+                               const char *host, uint16_t port)
+{
+  QTEL_Status_t status = QTEL_ERROR;
+
+  if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN) || !QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_AVAILABLE))
+  {
+    return QTEL_ERROR;
+  }
+
+  if (*connId == -1 || hqtel->net.sockets[*connId] == NULL) {
+    Get_Available_LinkNum(hqtel, connId);
+    if (*connId == -1) return QTEL_ERROR;
+  }
+
+  QTEL_LOCK(hqtel);
+  QTEL_SendCMD(hqtel,
+               "AT+QSSLOPEN=%u,%u,%d,\"%s\",%d,0",
+               (uint) hqtel->net.contextId, (uint) sslCtxId, (int) *connId, host, port);
+
+  setLinkState(hqtel, *connId, QTEL_SOCK_STATE_OPENING);
+
+  if (!QTEL_IsResponseOK(hqtel)) {
+    setLinkState(hqtel, *connId, QTEL_SOCK_STATE_CLOSED);
+    goto endcmd;
+  }
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+#endif /* QTEL_EN_FEATURE_SSL */
+
+
 QTEL_Status_t QTEL_SockClose(QTEL_HandlerTypeDef *hqtel, uint8_t connId)
 {
   QTEL_Status_t status  = QTEL_ERROR;
   uint8_t       *resp   = &hqtel->respTmp[0];
-  QTEL_Socket_t *socket;
+  QTEL_Socket_t *socket = NULL;
+
+  if (connId < QTEL_NUM_OF_SOCKET)
+    socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
 
   QTEL_LOCK(hqtel);
 
   memset(resp, 0, 20);
-  QTEL_SendCMD(hqtel, "AT+QICLOSE=%u,2", (uint) connId); // timeout in 2sec
+  if (socket != NULL && socket->type == QTEL_SOCK_SSL)
+    QTEL_SendCMD(hqtel, "AT+QSSLCLOSE=%u,2", (uint) connId); // timeout in 2sec
+  else
+    QTEL_SendCMD(hqtel, "AT+QICLOSE=%u,2", (uint) connId); // timeout in 2sec
 
   if (!QTEL_IsResponseOK(hqtel)) goto endcmd;
 
-  socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
   if (socket != NULL) {
-    QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_CLOSED);
+    setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_CLOSED);
     QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
   }
   status = QTEL_OK;
@@ -298,29 +525,180 @@ QTEL_Status_t QTEL_SockClose(QTEL_HandlerTypeDef *hqtel, uint8_t connId)
 }
 
 
-uint16_t QTEL_SockSendData(QTEL_HandlerTypeDef *hqtel, int8_t connId, const uint8_t *data, uint16_t length)
+/**
+ * get sent data counters of the modem for TCP connection,
+ * not supported by SSL connection
+ */
+QTEL_Status_t QTEL_SockGetSendState(QTEL_HandlerTypeDef *hqtel, int8_t connId,
+                                    uint32_t *totalLen, uint32_t *ackedLen, uint32_t *unackedLen)
 {
-  uint16_t  sendLen = 0;
-  uint8_t   *cmdTmp = &hqtel->cmdTmp[0];
+  QTEL_Status_t status  = QTEL_ERROR;
+  uint8_t       *resp   = &hqtel->respTmp[0];
+  char          *strTmp = (char*) &hqtel->respTmp[40];
+  const uint8_t *nextBuf;
+  QTEL_Socket_t *socket;
+
+  if (connId < 0 || connId >= QTEL_NUM_OF_SOCKET) return QTEL_ERROR;
+  socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
+  if (socket != NULL && socket->type == QTEL_SOCK_SSL) return QTEL_ERROR;
 
   QTEL_LOCK(hqtel);
 
-  sprintf((char*) cmdTmp, "AT+QISEND=%d,%d\r", (int) connId, (int) length);
-  QTEL_SendData(hqtel, cmdTmp, strlen((char*)cmdTmp));
-  if (!QTEL_WaitResponse(hqtel, ">", 1, 3000))
-    goto endcmd;
-  if (!QTEL_SendData(hqtel, data, length))
+  memset(resp, 0, 40);
+  QTEL_SendCMD(hqtel, "AT+QISEND=%d,0", (int) connId);
+  if (QTEL_GetResponse(hqtel, "+QISEND", 7, resp, 39, QTEL_GETRESP_WAIT_OK, 2000) != QTEL_OK)
     goto endcmd;
-  if (QTEL_GetResponse(hqtel, "SEND OK", 7, 0, 0, QTEL_GETRESP_ONLY_DATA, 5000) == QTEL_OK) {
-    sendLen = length;
+
+  memset(strTmp, 0, 11);
+  nextBuf = QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  if (totalLen != NULL) *totalLen = (uint32_t) atol(strTmp);
+
+  memset(strTmp, 0, 11);
+  nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  if (ackedLen != NULL) *ackedLen = (uint32_t) atol(strTmp);
+
+  memset(strTmp, 0, 11);
+  QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  if (unackedLen != NULL) *unackedLen = (uint32_t) atol(strTmp);
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+/**
+ * summary of all sockets, connected time includes the running connections
+ */
+void QTEL_SockGetStats(QTEL_HandlerTypeDef *hqtel, QTEL_Sock_Stats_t *stats)
+{
+  QTEL_Socket_t *socket;
+  uint16_t      links;
+  uint8_t       i;
+
+  QTEL_LOCK(hqtel);
+  *stats = hqtel->net.sockStats;
+  links = hqtel->net.sockLinks;
+  while (links) {
+    i = __builtin_ctz(links);
+    QTEL_BITS_UNSET(links, (1 << i));
+    socket = (QTEL_Socket_t*) hqtel->net.sockets[i];
+    if (socket != NULL && QTEL_SOCK_IS_STATE(socket, QTEL_SOCK_STATE_OPEN))
+      stats->connectedTime += QTEL_GetTick() - socket->tick.state;
   }
-  else {
-    sendLen = 0;
+  QTEL_UNLOCK(hqtel);
+}
+
+
+void QTEL_SockResetStats(QTEL_HandlerTypeDef *hqtel)
+{
+  memset(&hqtel->net.sockStats, 0, sizeof(QTEL_Sock_Stats_t));
+}
+
+
+void QTEL_SockRemoveListener(QTEL_HandlerTypeDef *hqtel, uint8_t connId)
+{
+  if (connId >= QTEL_NUM_OF_SOCKET) return;
+  unregisterSocket(hqtel, connId);
+}
+
+
+uint16_t QTEL_SockSendData(QTEL_HandlerTypeDef *hqtel, int8_t connId, const uint8_t *data, uint16_t length)
+{
+  QTEL_Sock_Span_t span = {data, length};
+
+  return (uint16_t) QTEL_SockSendSpans(hqtel, connId, &span, 1, NULL, NULL);
+}
+
+
+/**
+ * send data which is scattered in several spans as one stream,
+ * splitted per QTEL_SOCK_SEND_CHUNK_SIZE for each AT+QISEND
+ * return length of data that was sent
+ */
+uint32_t QTEL_SockSendSpans(QTEL_HandlerTypeDef *hqtel, int8_t connId,
+                            const QTEL_Sock_Span_t *spans, uint8_t spanNum,
+                            QTEL_Sock_Progress_Func progress, void *ctx)
+{
+  uint32_t  totalLen  = 0;
+  uint32_t  sentLen   = 0;
+  uint32_t  spanPos   = 0;
+  uint32_t  writeLen;
+  uint16_t  chunkLen;
+  uint16_t  remainLen;
+  uint32_t  sendTick;
+  uint8_t   spanIdx   = 0;
+  uint8_t   i;
+
+  for (i = 0; i < spanNum; i++) {
+    totalLen += spans[i].length;
+  }
+
+  while (sentLen < totalLen) {
+    if (totalLen - sentLen > QTEL_SOCK_SEND_CHUNK_SIZE) chunkLen = QTEL_SOCK_SEND_CHUNK_SIZE;
+    else                                                chunkLen = (uint16_t) (totalLen - sentLen);
+
+    sendTick = QTEL_GetTick();
+    QTEL_LOCK(hqtel);
+    if (!sendChunkStart(hqtel, connId, chunkLen))
+      goto endcmd;
+
+    remainLen = chunkLen;
+    while (remainLen) {
+      // move to the next span when current span was sent
+      while (spanPos >= spans[spanIdx].length) {
+        spanIdx++;
+        spanPos = 0;
+      }
+
+      writeLen = spans[spanIdx].length - spanPos;
+      if (writeLen > remainLen) writeLen = remainLen;
+
+      if (!QTEL_SendData(hqtel, spans[spanIdx].data + spanPos, (uint16_t) writeLen)) {
+        sendChunkAbort(hqtel, connId, remainLen);
+        goto endcmd;
+      }
+      spanPos   += writeLen;
+      remainLen -= (uint16_t) writeLen;
+    }
+
+    if (!sendChunkFinish(hqtel))
+      goto endcmd;
+    QTEL_UNLOCK(hqtel);
+    updateSendStats(hqtel, connId, chunkLen, QTEL_GetTick() - sendTick);
+
+    sentLen += chunkLen;
+    if (progress != NULL) progress(ctx, sentLen, totalLen);
   }
 
+  return sentLen;
+
   endcmd:
   QTEL_UNLOCK(hqtel);
-  return sendLen;
+  updateSendStats(hqtel, connId, 0, 0);
+  return sentLen;
+}
+
+
+/**
+ * send length bytes which are pulled from producer,
+ * producer must be able to provide all of length bytes,
+ * otherwise the connection is closed
+ * return length of data that was sent
+ */
+uint32_t QTEL_SockSendStream(QTEL_HandlerTypeDef *hqtel, int8_t connId, uint32_t length,
+                             QTEL_Sock_Producer_Func producer, QTEL_Sock_Progress_Func progress,
+                             void *ctx)
+{
+  return sendStream(hqtel, connId, length, producer, ctx, progress, ctx);
+}
+
+
+uint32_t QTEL_SockSendBuffer(QTEL_HandlerTypeDef *hqtel, int8_t connId, Buffer_t *src, uint32_t length,
+                             QTEL_Sock_Progress_Func progress, void *ctx)
+{
+  return sendStream(hqtel, connId, length, bufferProducer, src, progress, ctx);
 }
 
 
@@ -332,6 +710,7 @@ QTEL_Status_t QTEL_SOCK_Init(QTEL_Socket_t *sock, const char *host, uint16_t por
     host++;
     sockIP++;
   }
+  *sockIP = 0;
 
   sock->port = port;
 
@@ -339,8 +718,41 @@ QTEL_Status_t QTEL_SOCK_Init(QTEL_Socket_t *sock, const char *host, uint16_t por
     sock->config.timeout = QTEL_SOCK_DEFAULT_TO;
   if (sock->config.reconnectingDelay == 0)
     sock->config.reconnectingDelay = 5000;
+  if (sock->config.reconnectingMultiplier == 0)
+    sock->config.reconnectingMultiplier = 200;
+  if (sock->config.reconnectingDelayMax == 0)
+    sock->config.reconnectingDelayMax = 300000;
+  if (sock->config.reconnectingJitter > 100)
+    sock->config.reconnectingJitter = 100;
+  memset(&sock->reconnect, 0, sizeof(sock->reconnect));
+
+  if ((sock->buffer.buffer == NULL || sock->buffer.size == 0) && sock->rx.buffer == NULL)
+    return QTEL_ERROR;
+
+  QTEL_SOCK_SET_STATE(sock, QTEL_SOCK_STATE_CLOSED);
+  return QTEL_OK;
+}
+
 
-  if (sock->buffer.buffer == NULL || sock->buffer.size == 0)
+QTEL_Status_t QTEL_SOCK_InitListener(QTEL_Socket_t *sock, uint16_t localPort)
+{
+  strcpy(sock->host, "127.0.0.1");
+  sock->port = localPort;
+  sock->type = QTEL_SOCK_TCP_LISTENER;
+
+  if (sock->config.timeout == 0)
+    sock->config.timeout = QTEL_SOCK_DEFAULT_TO;
+  if (sock->config.reconnectingDelay == 0)
+    sock->config.reconnectingDelay = 5000;
+  if (sock->config.reconnectingMultiplier == 0)
+    sock->config.reconnectingMultiplier = 200;
+  if (sock->config.reconnectingDelayMax == 0)
+    sock->config.reconnectingDelayMax = 300000;
+  if (sock->config.reconnectingJitter > 100)
+    sock->config.reconnectingJitter = 100;
+  memset(&sock->reconnect, 0, sizeof(sock->reconnect));
+
+  if (sock->listeners.onAccept == NULL)
     return QTEL_ERROR;
 
   QTEL_SOCK_SET_STATE(sock, QTEL_SOCK_STATE_CLOSED);
@@ -348,6 +760,16 @@ QTEL_Status_t QTEL_SOCK_Init(QTEL_Socket_t *sock, const char *host, uint16_t por
 }
 
 
+#if QTEL_EN_FEATURE_SSL
+QTEL_Status_t QTEL_SOCK_InitSSL(QTEL_Socket_t *sock, uint8_t sslCtxId, const char *host, uint16_t port)
+{
+  sock->type = QTEL_SOCK_SSL;
+  sock->config.sslCtxId = sslCtxId;
+  return QTEL_SOCK_Init(sock, host, port);
+}
+#endif /* QTEL_EN_FEATURE_SSL */
+
+
 void QTEL_SOCK_SetBuffer(QTEL_Socket_t *sock, uint8_t *buffer, uint16_t size)
 {
   sock->buffer.buffer = buffer;
@@ -355,21 +777,68 @@ void QTEL_SOCK_SetBuffer(QTEL_Socket_t *sock, uint8_t *buffer, uint16_t size)
 }
 
 
+/**
+ * set receiving ring for zero-copy reading, set it before opening so data
+ * is kept by the modem while the ring is full,
+ * the last byte of buffer is reserved for forwarding data from serial
+ */
+void QTEL_SOCK_SetSpanBuffer(QTEL_Socket_t *sock, uint8_t *buffer, uint16_t size)
+{
+  memset(&sock->rx, 0, sizeof(sock->rx));
+  if (buffer == NULL || size < 3) return;
+  sock->rx.buffer = buffer;
+  sock->rx.size = size - 1;
+}
+
+
+/**
+ * get delivered data which is not consumed yet, return number of spans
+ */
+uint8_t QTEL_SOCK_PeekSpans(QTEL_Socket_t *sock, QTEL_Sock_Span_t spans[2])
+{
+  if (sock->rx.buffer == NULL) return 0;
+  return getRxSpans(sock, sock->rx.tail, sock->rx.delivered, spans);
+}
+
+
+/**
+ * release delivered data, length is limited to the delivered data
+ */
+void QTEL_SOCK_Consume(QTEL_Socket_t *sock, uint16_t length)
+{
+  uint16_t delivered = sock->rx.delivered;
+  uint16_t available;
+
+  if (sock->rx.buffer == NULL) return;
+
+  if (delivered >= sock->rx.tail) available = delivered - sock->rx.tail;
+  else available = sock->rx.size - sock->rx.tail + delivered;
+  if (length > available) length = available;
+
+  sock->rx.tail = (sock->rx.tail + length) % sock->rx.size;
+
+  // continue reading data kept by the modem
+  if (sock->rx.isStalled && sock->hqtel != NULL && sock->linkNum >= 0) {
+    sock->rx.isStalled = 0;
+    setSocketEvent(sock->hqtel, sock, QTEL_SOCK_EVENT_ON_RECV_PENDING);
+  }
+}
+
+
 QTEL_Status_t QTEL_SOCK_Open(QTEL_Socket_t *sock, QTEL_HandlerTypeDef *hqtel)
 {
   QTEL_Status_t status;
   sock->linkNum = -1;
 
-  if (sock->config.autoReconnect) {
-    Get_Available_LinkNum(hqtel, &(sock->linkNum));
-    if (sock->linkNum < 0) return QTEL_ERROR;
-    hqtel->net.sockets[sock->linkNum] = (void*)sock;
-    sock->hqtel = hqtel;
-  }
+  // socket is held in the table to get its events
+  Get_Available_LinkNum(hqtel, &(sock->linkNum));
+  if (sock->linkNum < 0) return QTEL_ERROR;
+  sock->hqtel = hqtel;
+  registerSocket(hqtel, sock);
 
   status = sockOpen(sock);
   if (status != QTEL_OK && !sock->config.autoReconnect) {
-    hqtel->net.sockets[sock->linkNum] = NULL;
+    unregisterSocket(hqtel, sock->linkNum);
     sock->linkNum = -1;
   }
 
@@ -379,11 +848,64 @@ QTEL_Status_t QTEL_SOCK_Open(QTEL_Socket_t *sock, QTEL_HandlerTypeDef *hqtel)
 
 static QTEL_Status_t sockOpen(QTEL_Socket_t *sock)
 {
-  if (QTEL_SockOpenTCPIP(sock->hqtel, &sock->linkNum, sock->host, sock->port) == QTEL_OK) {
+  QTEL_Status_t status;
+  #if QTEL_EN_FEATURE_DNS
+  char          ip[QTEL_DNS_IP_SIZE];
+  #endif
+
+  sock->latency.dns = 0;
+
+  #if QTEL_EN_FEATURE_DNS
+  // connect by cached address or wait for resolving in background,
+  // SSL keeps the host name for SNI and certificate check
+  if (sock->type == QTEL_SOCK_TCPIP) {
+    status = QTEL_DNS_Lookup(sock->hqtel, sock->host, ip);
+    if (status == QTEL_OK) {
+      status = sockConnect(sock, ip);
+      goto endopen;
+    }
+
+    if (status == QTEL_BUSY || QTEL_DNS_Resolve(sock->hqtel, sock->host) == QTEL_OK) {
+      QTEL_SOCK_SET_STATE(sock, QTEL_SOCK_STATE_OPENING);
+      QTEL_BITS_SET(sock->hqtel->net.sockResolving, (1 << sock->linkNum));
+      if (sock->listeners.onConnecting != NULL) sock->listeners.onConnecting();
+      return QTEL_OK;
+    }
+  }
+  #endif /* QTEL_EN_FEATURE_DNS */
+
+  status = sockConnect(sock, sock->host);
+
+  #if QTEL_EN_FEATURE_DNS
+  endopen:
+  #endif
+  if (status == QTEL_OK) {
     if (sock->listeners.onConnecting != NULL) sock->listeners.onConnecting();
-    return QTEL_OK;
   }
+  return status;
+}
+
+
+static QTEL_Status_t sockConnect(QTEL_Socket_t *sock, const char *host)
+{
+  QTEL_Status_t status;
+
+  sock->tick.connecting = QTEL_GetTick();
+
+  if (sock->type == QTEL_SOCK_TCP_LISTENER)
+    status = QTEL_SockOpenTCPListener(sock->hqtel, &sock->linkNum, sock->port);
+  #if QTEL_EN_FEATURE_SSL
+  else if (sock->type == QTEL_SOCK_SSL)
+    status = QTEL_SockOpenSSL(sock->hqtel, &sock->linkNum, sock->config.sslCtxId, host, sock->port);
+  #endif
+  else
+    status = QTEL_SockOpenTCPIP(sock->hqtel, &sock->linkNum, host, sock->port);
+
+  if (status == QTEL_OK) return QTEL_OK;
+
   QTEL_SOCK_SET_STATE(sock, QTEL_SOCK_STATE_CLOSED);
+  if (sock->config.autoReconnect)
+    setSocketReconnect(sock->hqtel, sock);
 
   return QTEL_ERROR;
 }
@@ -395,13 +917,46 @@ void QTEL_SOCK_Close(QTEL_Socket_t *sock)
 }
 
 
+uint32_t QTEL_SOCK_GetStateDuration(QTEL_Socket_t *sock)
+{
+  return QTEL_GetTick() - sock->tick.state;
+}
+
+
+void QTEL_SOCK_GetStats(QTEL_Socket_t *sock, QTEL_Sock_Stats_t *stats)
+{
+  if (sock->hqtel != NULL) QTEL_LOCK(sock->hqtel);
+  *stats = sock->stats;
+  if (QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN))
+    stats->connectedTime += QTEL_GetTick() - sock->tick.state;
+  if (sock->hqtel != NULL) QTEL_UNLOCK(sock->hqtel);
+}
+
+
+void QTEL_SOCK_ResetStats(QTEL_Socket_t *sock)
+{
+  memset(&sock->stats, 0, sizeof(QTEL_Sock_Stats_t));
+}
+
+
 uint16_t QTEL_SOCK_SendData(QTEL_Socket_t *sock, const uint8_t *data, uint16_t length)
 {
   if (!QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN)) return 0;
+  if (sock->type == QTEL_SOCK_TCP_LISTENER) return 0;
   return QTEL_SockSendData(sock->hqtel, sock->linkNum, data, length);
 }
 
 
+uint32_t QTEL_SOCK_SendStream(QTEL_Socket_t *sock, uint32_t length,
+                              QTEL_Sock_Producer_Func producer, QTEL_Sock_Progress_Func progress,
+                              void *ctx)
+{
+  if (!QTEL_SOCK_IS_STATE(sock, QTEL_SOCK_STATE_OPEN)) return 0;
+  if (sock->type == QTEL_SOCK_TCP_LISTENER) return 0;
+  return QTEL_SockSendStream(sock->hqtel, sock->linkNum, length, producer, progress, ctx);
+}
+
+
 static QTEL_Status_t setTCPDefaultConfiguration(QTEL_HandlerTypeDef *hqtel)
 {
   QTEL_Status_t status        = QTEL_ERROR;
@@ -470,6 +1025,25 @@ static QTEL_Status_t setTCPDefaultConfiguration(QTEL_HandlerTypeDef *hqtel)
 
 
 static void resetOpenedSocket(QTEL_HandlerTypeDef *hqtel)
+{
+  QTEL_LOCK(hqtel);
+
+  if (closeListedSocket(hqtel, "+QISTATE", "AT+QICLOSE")) {
+    QTEL_NET_SET_STATUS(hqtel, QTEL_NET_STATUS_AVAILABLE);
+  }
+
+  #if QTEL_EN_FEATURE_SSL
+  closeListedSocket(hqtel, "+QSSLSTATE", "AT+QSSLCLOSE");
+  #endif
+
+  QTEL_UNLOCK(hqtel);
+}
+
+
+/*
+ * close every connection which is listed by stateCmd (AT+QISTATE or AT+QSSLSTATE)
+ */
+static uint8_t closeListedSocket(QTEL_HandlerTypeDef *hqtel, const char *stateCmd, const char *closeCmd)
 {
   uint8_t *resp         = &hqtel->respTmp[0];
   uint8_t respDataSz    = 10;
@@ -478,25 +1052,304 @@ static void resetOpenedSocket(QTEL_HandlerTypeDef *hqtel)
 
   if (respSz > 12) respSz = 12;
 
-  QTEL_LOCK(hqtel);
   memset(resp, 0, 20);
 
-  QTEL_SendCMD(hqtel, "AT+QISTATE");
-  if (QTEL_GetMultipleResponse(hqtel, "+QISTATE", 8,
+  // stateCmd without "+" is the AT command
+  QTEL_SendCMD(hqtel, "AT%s", stateCmd);
+  if (QTEL_GetMultipleResponse(hqtel, stateCmd, strlen(stateCmd),
                                resp, respSz, respDataSz,
-                               QTEL_GETRESP_WAIT_OK, 1000) == QTEL_OK)
+                               QTEL_GETRESP_WAIT_OK, 1000) != QTEL_OK)
   {
-    while(respSz--) {
-      if (*resp == 0) break;
-      connId = (uint8_t) atoi((char*) resp);
-      QTEL_SendCMD(hqtel, "AT+QICLOSE=%u,2", (uint) connId); // timeout in 2sec
-      if (!QTEL_IsResponseOK(hqtel)){}
-      resp += respDataSz;
+    return 0;
+  }
+
+  while(respSz--) {
+    if (*resp == 0) break;
+    connId = (uint8_t) atoi((char*) resp);
+    QTEL_SendCMD(hqtel, "%s=%u,2", closeCmd, (uint) connId); // timeout in 2sec
+    if (!QTEL_IsResponseOK(hqtel)){}
+    resp += respDataSz;
+  }
+  return 1;
+}
+
+
+static void registerSocket(QTEL_HandlerTypeDef *hqtel, QTEL_Socket_t *socket)
+{
+  hqtel->net.sockets[socket->linkNum] = (void*) socket;
+  QTEL_BITS_SET(hqtel->net.sockLinks, (1 << socket->linkNum));
+}
+
+
+static void unregisterSocket(QTEL_HandlerTypeDef *hqtel, uint8_t connId)
+{
+  hqtel->net.sockets[connId] = NULL;
+  QTEL_BITS_UNSET(hqtel->net.sockLinks, (1 << connId));
+  QTEL_BITS_UNSET(hqtel->net.sockEvents, (1 << connId));
+  QTEL_BITS_UNSET(hqtel->net.sockReconnects, (1 << connId));
+  #if QTEL_EN_FEATURE_DNS
+  QTEL_BITS_UNSET(hqtel->net.sockResolving, (1 << connId));
+  #endif
+}
+
+
+static void setSocketEvent(QTEL_HandlerTypeDef *hqtel, QTEL_Socket_t *socket, uint8_t event)
+{
+  QTEL_BITS_SET(socket->events, event);
+  QTEL_BITS_SET(hqtel->net.sockEvents, (1 << socket->linkNum));
+}
+
+
+static void setSocketReconnect(QTEL_HandlerTypeDef *hqtel, QTEL_Socket_t *socket)
+{
+  socket->tick.reconnDelay = QTEL_GetTick();
+  socket->reconnect.delay = getReconnectDelay(socket);
+  if (socket->reconnect.attempt < 0xFFFF) socket->reconnect.attempt++;
+  QTEL_BITS_SET(hqtel->net.sockReconnects, (1 << socket->linkNum));
+}
+
+
+/*
+ * exponential backoff: base * multiplier^attempt, capped,
+ * then spread randomly by jitter percent
+ */
+static uint32_t getReconnectDelay(QTEL_Socket_t *socket)
+{
+  uint32_t delay = socket->config.reconnectingDelay;
+  uint32_t delayMax = socket->config.reconnectingDelayMax;
+  uint32_t jitter;
+  uint16_t i;
+
+  if (delayMax < delay) delayMax = delay;
+
+  for (i = 0; i < socket->reconnect.attempt && delay < delayMax; i++) {
+    delay = delay * socket->config.reconnectingMultiplier / 100;
+  }
+  if (delay > delayMax) delay = delayMax;
+
+  jitter = delay * socket->config.reconnectingJitter / 100;
+  if (jitter) {
+    delay = delay - jitter + (QTEL_Random() % (2*jitter + 1));
+  }
+
+  return delay;
+}
+
+
+static void setLinkState(QTEL_HandlerTypeDef *hqtel, int8_t connId, uint8_t state)
+{
+  QTEL_Socket_t *socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
+  if (socket != NULL) QTEL_SOCK_SET_STATE(socket, state);
+}
+
+
+/*
+ * <connectID>,<err>
+ */
+static void setOpenResult(QTEL_HandlerTypeDef *hqtel, const uint8_t *resp)
+{
+  char          *strTmp = (char*) &hqtel->respTmp[0];
+  uint8_t       connId;
+  uint16_t      err;
+  QTEL_Socket_t *socket;
+
+  memset(strTmp, 0, 3);
+  resp    = QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  connId  = (uint8_t) atoi(strTmp);
+
+  memset(strTmp, 0, 4);
+  QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  err     = (uint16_t) atoi(strTmp);
+
+  if (connId >= QTEL_NUM_OF_SOCKET) return;
+
+  socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
+  if (socket != NULL) {
+    socket->error = err;
+    if (err == 0) {
+      socket->reconnect.attempt = 0;
+      socket->latency.connect = QTEL_GetTick() - socket->tick.connecting;
+      setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_OPENED);
+      QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_OPEN);
+    } else {
+      setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_OPENING_ERROR);
+      QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
     }
-    QTEL_NET_SET_STATUS(hqtel, QTEL_NET_STATUS_AVAILABLE);
   }
+}
+
+
+/*
+ * <connectID>
+ */
+static void setClosedByServer(QTEL_HandlerTypeDef *hqtel, const uint8_t *resp)
+{
+  char          *strTmp = (char*) &hqtel->respTmp[0];
+  uint8_t       connId;
+  QTEL_Socket_t *socket;
+
+  memset(strTmp, 0, 3);
+  QTEL_ParseStr(resp, ',', 0, (uint8_t*) strTmp);
+  connId = (uint8_t) atoi(strTmp);
+
+  if (connId >= QTEL_NUM_OF_SOCKET) return;
+
+  socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
+  if (socket != NULL) {
+    setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_CLOSED_BY_SVR|QTEL_SOCK_EVENT_ON_CLOSED);
+    QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
+  }
+}
+
+
+static uint8_t sendChunkStart(QTEL_HandlerTypeDef *hqtel, int8_t connId, uint16_t length)
+{
+  uint8_t       *cmdTmp = &hqtel->cmdTmp[0];
+  const char    *cmd    = "AT+QISEND";
+  QTEL_Socket_t *socket;
+
+  if (connId >= 0 && connId < QTEL_NUM_OF_SOCKET
+      && (socket = (QTEL_Socket_t*) hqtel->net.sockets[connId]) != NULL
+      && socket->type == QTEL_SOCK_SSL)
+  {
+    cmd = "AT+QSSLSEND";
+  }
+
+  sprintf((char*) cmdTmp, "%s=%d,%d\r", cmd, (int) connId, (int) length);
+  if (!QTEL_SendData(hqtel, cmdTmp, strlen((char*)cmdTmp)))
+    return 0;
+  return QTEL_WaitResponse(hqtel, ">", 1, 3000);
+}
+
+
+static uint8_t sendChunkFinish(QTEL_HandlerTypeDef *hqtel)
+{
+  return QTEL_GetResponse(hqtel, "SEND OK", 7, 0, 0, QTEL_GETRESP_ONLY_DATA, 5000) == QTEL_OK;
+}
+
+
+/*
+ * the modem takes all of declared length after the prompt before
+ * any command, so the rest of the chunk is padded and its result is
+ * waited, the chunk is counted as failed. the padding goes to the peer,
+ * so the connection is closed to not continue the corrupted stream
+ */
+static void sendChunkAbort(QTEL_HandlerTypeDef *hqtel, int8_t connId, uint16_t remainLen)
+{
+  uint8_t       *padding = &hqtel->cmdTmp[0];
+  uint16_t      writeLen;
+  QTEL_Socket_t *socket;
+
+  memset(padding, 0, sizeof(hqtel->cmdTmp));
+  while (remainLen) {
+    writeLen = (remainLen < sizeof(hqtel->cmdTmp))? remainLen : sizeof(hqtel->cmdTmp);
+    if (!QTEL_SendData(hqtel, padding, writeLen)) break;
+    remainLen -= writeLen;
+  }
+  QTEL_GetResponse(hqtel, "SEND", 4, 0, 0, QTEL_GETRESP_ONLY_DATA, 5000);
+
+  if (connId < 0 || connId >= QTEL_MAX_NUM_OF_SOCKET) return;
 
+  // closed by the event handler, the lock is still held here
+  if (connId < QTEL_NUM_OF_SOCKET
+      && (socket = (QTEL_Socket_t*) hqtel->net.sockets[connId]) != NULL)
+  {
+    QTEL_SOCK_SET_STATE(socket, QTEL_SOCK_STATE_CLOSED);
+  }
+  QTEL_BITS_SET(hqtel->net.sockCloseReqs, (1 << connId));
+}
+
+
+static uint32_t sendStream(QTEL_HandlerTypeDef *hqtel, int8_t connId, uint32_t length,
+                           QTEL_Sock_Producer_Func producer, void *producerCtx,
+                           QTEL_Sock_Progress_Func progress, void *progressCtx)
+{
+  uint8_t   *dataTmp  = &hqtel->cmdTmp[0];
+  uint32_t  sentLen   = 0;
+  uint16_t  chunkLen;
+  uint16_t  remainLen;
+  uint16_t  readLen;
+  uint16_t  reqLen;
+  uint32_t  sendTick;
+
+  if (producer == NULL) return 0;
+
+  while (sentLen < length) {
+    if (length - sentLen > QTEL_SOCK_SEND_CHUNK_SIZE) chunkLen = QTEL_SOCK_SEND_CHUNK_SIZE;
+    else                                              chunkLen = (uint16_t) (length - sentLen);
+
+    sendTick = QTEL_GetTick();
+    QTEL_LOCK(hqtel);
+    if (!sendChunkStart(hqtel, connId, chunkLen))
+      goto endcmd;
+
+    // cmdTmp is free after the prompt, use it to pull the data
+    remainLen = chunkLen;
+    while (remainLen) {
+      reqLen  = (remainLen < sizeof(hqtel->cmdTmp))? remainLen : sizeof(hqtel->cmdTmp);
+      readLen = producer(producerCtx, dataTmp, reqLen);
+      if (readLen == 0 || readLen > reqLen || !QTEL_SendData(hqtel, dataTmp, readLen)) {
+        sendChunkAbort(hqtel, connId, remainLen);
+        goto endcmd;
+      }
+      remainLen -= readLen;
+    }
+
+    if (!sendChunkFinish(hqtel))
+      goto endcmd;
+    QTEL_UNLOCK(hqtel);
+    updateSendStats(hqtel, connId, chunkLen, QTEL_GetTick() - sendTick);
+
+    sentLen += chunkLen;
+    if (progress != NULL) progress(progressCtx, sentLen, length);
+  }
+
+  return sentLen;
+
+  endcmd:
   QTEL_UNLOCK(hqtel);
+  updateSendStats(hqtel, connId, 0, 0);
+  return sentLen;
+}
+
+
+static uint16_t bufferProducer(void *ctx, uint8_t *dstBuf, uint16_t bufSz)
+{
+  return Buffer_Read((Buffer_t*) ctx, dstBuf, bufSz);
+}
+
+
+/*
+ * length 0 means failed sending
+ */
+static void updateSendStats(QTEL_HandlerTypeDef *hqtel, int8_t connId, uint16_t length, uint32_t latency)
+{
+  QTEL_Sock_Stats_t *stats[2] = {&hqtel->net.sockStats, NULL};
+  QTEL_Socket_t     *socket;
+
+  if (connId >= 0 && connId < QTEL_NUM_OF_SOCKET
+      && (socket = (QTEL_Socket_t*) hqtel->net.sockets[connId]) != NULL)
+  {
+    stats[1] = &socket->stats;
+  }
+
+  for (uint8_t i = 0; i < 2 && stats[i] != NULL; i++) {
+    if (length == 0) {
+      stats[i]->txFailed++;
+      continue;
+    }
+    stats[i]->txBytes += length;
+    stats[i]->txCount++;
+    stats[i]->txLatencyTotal += latency;
+    if (latency > stats[i]->txLatencyMax) stats[i]->txLatencyMax = latency;
+  }
+}
+
+
+static void updateRecvStats(QTEL_HandlerTypeDef *hqtel, QTEL_Socket_t *socket, uint16_t length)
+{
+  hqtel->net.sockStats.rxBytes += length;
+  socket->stats.rxBytes += length;
 }
 
 
@@ -507,7 +1360,6 @@ static void receiveData(QTEL_HandlerTypeDef *hqtel)
   uint8_t       *dataLen_str  = &hqtel->respTmp[8];
   uint8_t       connId;
   uint16_t      dataLen;
-  uint16_t      writeLen;
   QTEL_Socket_t *socket;
 
   memset(connId_str, 0, 2);
@@ -521,22 +1373,254 @@ static void receiveData(QTEL_HandlerTypeDef *hqtel)
 
   if (connId < QTEL_NUM_OF_SOCKET && hqtel->net.sockets[connId] != NULL) {
     socket = (QTEL_Socket_t*) hqtel->net.sockets[connId];
-    while (dataLen) {
+
+    // buffer access mode, data is kept by the modem, read it later with AT+QIRD
+    if (*dataLen_str == 0) {
+      setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_RECV_PENDING);
+      return;
+    }
+    forwardRecvData(hqtel, socket, dataLen);
+    setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_RECEIVED);
+  }
+}
+
+
+/*
+ * forward received data from serial to socket buffer,
+ * span buffer links are read by request up to free space, but pushed data
+ * can't be left in the modem, so what a full span buffer can't hold
+ * is discarded and the owner is told about it
+ */
+static uint8_t forwardRecvData(QTEL_HandlerTypeDef *hqtel, QTEL_Socket_t *socket, uint16_t dataLen)
+{
+  Buffer_t  chunk;
+  uint16_t  writeLen;
+  uint8_t   isDropped;
+
+  while (dataLen) {
+    if (socket->rx.buffer == NULL) {
       if (dataLen > socket->buffer.size)  writeLen = socket->buffer.size;
       else                                writeLen = dataLen;
 
       if (hqtel->serial.forwardToBuffer(hqtel->serial.device, &socket->buffer, writeLen, 5000) > 0)
-        break;
+        return 0;
 
       dataLen -= writeLen;
+      updateRecvStats(hqtel, socket, writeLen);
 
       if (socket->listeners.onReceived != NULL)
         socket->listeners.onReceived(&(socket->buffer));
+      continue;
+    }
+
+    // full ring, give the listener a chance to consume delivered data
+    if (getRxSpace(socket, 1) == 0) deliverRxSpans(socket);
+
+    // forward into fresh buffer which is aliasing the contiguous free space
+    memset(&chunk, 0, sizeof(Buffer_t));
+    writeLen = getRxSpace(socket, 1);
+    isDropped = (writeLen == 0);
+    if (isDropped) {
+      chunk.buffer = &hqtel->respTmp[0];
+      writeLen = QTEL_TMP_RESP_BUFFER_SIZE - 1;
     }
+    else chunk.buffer = &socket->rx.buffer[socket->rx.head];
+    if (writeLen > dataLen) writeLen = dataLen;
+    chunk.size = writeLen + 1;
+
+    if (hqtel->serial.forwardToBuffer(hqtel->serial.device, &chunk, writeLen, 5000) > 0)
+      return 0;
+
+    dataLen -= writeLen;
+    if (isDropped) {
+      socket->stats.rxDropped += writeLen;
+      hqtel->net.sockStats.rxDropped += writeLen;
+      setSocketEvent(hqtel, socket, QTEL_SOCK_EVENT_ON_RX_DROPPED);
+      continue;
+    }
+    socket->rx.head = (socket->rx.head + writeLen) % socket->rx.size;
+    updateRecvStats(hqtel, socket, writeLen);
+  }
+
+  return 1;
+}
+
+
+/*
+ * free space of span buffer, one byte is kept to separate head from tail
+ */
+static uint16_t getRxSpace(QTEL_Socket_t *socket, uint8_t isContiguous)
+{
+  uint16_t head = socket->rx.head;
+  uint16_t tail = socket->rx.tail;
+
+  if (tail > head) return tail - head - 1;
+  if (isContiguous) return socket->rx.size - head - (tail == 0 ? 1 : 0);
+  return socket->rx.size - head + tail - 1;
+}
+
+
+static uint8_t getRxSpans(QTEL_Socket_t *socket, uint16_t from, uint16_t to, QTEL_Sock_Span_t spans[2])
+{
+  if (from == to) return 0;
+
+  spans[0].data = &socket->rx.buffer[from];
+  if (to > from) {
+    spans[0].length = to - from;
+    return 1;
+  }
+
+  spans[0].length = socket->rx.size - from;
+  if (to == 0) return 1;
+  spans[1].data = &socket->rx.buffer[0];
+  spans[1].length = to;
+  return 2;
+}
+
+
+/*
+ * pass data which is not delivered yet to the listener, only once
+ */
+static void deliverRxSpans(QTEL_Socket_t *socket)
+{
+  QTEL_Sock_Span_t  spans[2];
+  uint8_t           spanNum;
+
+  spanNum = getRxSpans(socket, socket->rx.delivered, socket->rx.head, spans);
+  if (spanNum == 0) return;
+  socket->rx.delivered = socket->rx.head;
+
+  if (socket->listeners.onReceivedSpans != NULL)
+    socket->listeners.onReceivedSpans(socket, spans, spanNum);
+}
+
+
+/*
+ * pull data kept by the modem with AT+QIRD (or AT+QSSLRECV for SSL)
+ * until it's empty or the socket buffer is full
+ */
+static void receiveKeptData(QTEL_Socket_t *socket)
+{
+  QTEL_HandlerTypeDef *hqtel  = socket->hqtel;
+  uint8_t             *resp   = &hqtel->respTmp[0];
+  const char          *cmd    = "AT+QIRD";
+  const char          *prefix = "+QIRD";
+  uint16_t            recvSize = QTEL_SOCK_RECV_SIZE;
+  uint16_t            reqLen;
+  uint16_t            dataLen;
+  uint8_t             isReceived = 0;
+
+  #if QTEL_EN_FEATURE_SSL
+  if (socket->type == QTEL_SOCK_SSL) {
+    cmd = "AT+QSSLRECV";
+    prefix = "+QSSLRECV";
+    recvSize = QTEL_SSL_RECV_SIZE;
+  }
+  #endif
+
+  QTEL_LOCK(hqtel);
+  while (1) {
+    reqLen = recvSize;
+    if (socket->rx.buffer != NULL) {
+      // keep data in the modem until the listener consumes the span buffer
+      if (getRxSpace(socket, 0) == 0) deliverRxSpans(socket);
+      if (reqLen > getRxSpace(socket, 0)) reqLen = getRxSpace(socket, 0);
+      if (reqLen == 0) {
+        socket->rx.isStalled = 1;
+        break;
+      }
+    }
+    else if (reqLen > socket->buffer.size) reqLen = socket->buffer.size;
+
+    QTEL_SendCMD(hqtel, "%s=%d,%u", cmd, (int) socket->linkNum, reqLen);
+
+    memset(resp, 0, 6);
+    if (QTEL_GetResponse(hqtel, prefix, strlen(prefix), resp, 6, QTEL_GETRESP_ONLY_DATA, 2000) != QTEL_OK)
+      break;
+    dataLen = (uint16_t) atoi((char*) resp);
 
+    if (dataLen > 0 && !forwardRecvData(hqtel, socket, dataLen)) break;
+    if (!QTEL_IsResponseOK(hqtel)) break;
+    if (dataLen == 0) break;
+
+    isReceived = 1;
+    if (dataLen < reqLen) break;
+  }
+  QTEL_UNLOCK(hqtel);
+
+  if (isReceived) {
     QTEL_BITS_SET(socket->events, QTEL_SOCK_EVENT_ON_RECEIVED);
   }
 }
 
 
+/**
+ * +QIURC: "incoming",<connectID>,<serverID>,<remoteIP>,<remote_port>
+ */
+static void acceptIncoming(QTEL_HandlerTypeDef *hqtel, const uint8_t *nextBuf)
+{
+  char          *strTmp   = (char*) &hqtel->respTmp[16];
+  char          *remoteIP = (char*) &hqtel->respTmp[32];
+  uint8_t       connId;
+  uint8_t       serverId;
+  uint16_t      remotePort;
+  QTEL_Socket_t *server;
+  QTEL_Socket_t *client   = NULL;
+
+  memset(strTmp, 0, 4);
+  nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  connId = (uint8_t) atoi(strTmp);
+
+  memset(strTmp, 0, 4);
+  nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  serverId = (uint8_t) atoi(strTmp);
+
+  memset(remoteIP, 0, 48);
+  nextBuf = QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) remoteIP);
+
+  memset(strTmp, 0, 6);
+  QTEL_ParseStr(nextBuf, ',', 0, (uint8_t*) strTmp);
+  remotePort = (uint16_t) atoi(strTmp);
+
+  if (connId >= QTEL_MAX_NUM_OF_SOCKET) return;
+
+  if (serverId < QTEL_NUM_OF_SOCKET && connId < QTEL_NUM_OF_SOCKET
+      && hqtel->net.sockets[connId] == NULL
+      && (server = (QTEL_Socket_t*) hqtel->net.sockets[serverId]) != NULL
+      && server->type == QTEL_SOCK_TCP_LISTENER
+      && server->listeners.onAccept != NULL)
+  {
+    client = server->listeners.onAccept(server, remoteIP, remotePort);
+  }
+
+  if (client == NULL
+      || ((client->buffer.buffer == NULL || client->buffer.size == 0) && client->rx.buffer == NULL))
+  {
+    QTEL_BITS_SET(hqtel->net.sockCloseReqs, (1 << connId));
+    return;
+  }
+
+  strncpy(client->host, remoteIP, sizeof(client->host)-1);
+  client->hqtel   = hqtel;
+  client->port    = remotePort;
+  client->linkNum = (int8_t) connId;
+  client->type    = QTEL_SOCK_TCPIP;
+  client->config.autoReconnect = 0;
+  if (client->config.timeout == 0)
+    client->config.timeout = QTEL_SOCK_DEFAULT_TO;
+
+  // the struct may be reused from a previous connection
+  client->events = 0;
+  client->rx.head = 0;
+  client->rx.tail = 0;
+  client->rx.delivered = 0;
+  client->rx.isStalled = 0;
+  QTEL_SOCK_ResetStats(client);
+
+  registerSocket(hqtel, client);
+  QTEL_SOCK_SET_STATE(client, QTEL_SOCK_STATE_OPEN);
+  setSocketEvent(hqtel, client, QTEL_SOCK_EVENT_ON_OPENED);
+}
+
+
 #endif /* QTEL_EN_FEATURE_SOCKET */
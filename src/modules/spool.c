@@ -0,0 +1,508 @@
+/*
+ * spool.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/file.h"
+#include "../include/quectel/net.h"
+#include "../include/quectel/digest.h"
+#include "../include/quectel/spool.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdio.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_SPOOL
+
+#define RECORD_MAGIC  0xA5
+#define RECORD_COMMIT 0x5A
+#define FILENAME_SIZE (QTEL_SPOOL_NAME_SIZE + 4)
+
+typedef struct {
+  uint32_t  magic;
+  uint8_t   readSeg;
+  uint8_t   writeSeg;
+  uint16_t  seq;                            // newer of two slots is used
+  uint32_t  readPos;
+  uint32_t  crc;                            // of the fields above
+} SpoolPos_t;
+
+static QTEL_Status_t  loadPos(QTEL_Spool_t*);
+static QTEL_Status_t  savePos(QTEL_Spool_t*);
+static QTEL_Status_t  scanSegment(QTEL_Spool_t*, uint8_t seg, uint32_t countFrom);
+static QTEL_Status_t  switchSegment(QTEL_Spool_t*);
+static QTEL_Status_t  finishSegment(QTEL_Spool_t*);
+static QTEL_Status_t  replayBatch(QTEL_Spool_t*);
+static void           getSegFilename(QTEL_Spool_t*, uint8_t seg, char *filename);
+
+
+void QTEL_SPOOL_HandleEvents(QTEL_HandlerTypeDef *hqtel)
+{
+  QTEL_Spool_t *spool = (QTEL_Spool_t*) hqtel->file.spool;
+
+  if (spool == NULL || spool->replayInterval == 0 || spool->count == 0) return;
+
+  #if QTEL_EN_FEATURE_NET
+  if (!QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) return;
+  #endif
+
+  // one batch each pass, the next one follows immediately unless it fails
+  if (QTEL_IsTimeout(spool->tick, spool->replayInterval)) {
+    if (replayBatch(spool) != QTEL_OK)
+      spool->tick = QTEL_GetTick();
+  }
+}
+
+
+/*
+ * file handles are lost when the modem restarts
+ */
+void QTEL_SPOOL_OnStarted(QTEL_HandlerTypeDef *hqtel)
+{
+  QTEL_Spool_t  *spool = (QTEL_Spool_t*) hqtel->file.spool;
+  char          filename[FILENAME_SIZE];
+
+  if (spool == NULL) return;
+
+  getSegFilename(spool, spool->writeSeg, filename);
+  QTEL_File_Open(hqtel, &spool->writeFile, spool->storage, filename);
+}
+
+
+/**
+ * records left by previous run are recovered, an unfinished record
+ * and everything after it are cut from the segment
+ */
+QTEL_Status_t QTEL_SPOOL_Open(QTEL_HandlerTypeDef *hqtel, QTEL_Spool_t *spool)
+{
+  char filename[FILENAME_SIZE];
+
+  if (spool->name == NULL || strlen(spool->name) >= QTEL_SPOOL_NAME_SIZE) return QTEL_ERROR;
+  if (spool->buffer == NULL || spool->bufferSize <= QTEL_SPOOL_RECORD_OVERHEAD) return QTEL_ERROR;
+  if (spool->maxSize / 2 < spool->bufferSize) return QTEL_ERROR;
+
+  spool->hqtel = hqtel;
+  spool->count = 0;
+  spool->dropped = 0;
+  spool->tick = 0;
+  memset(spool->segLen, 0, sizeof(spool->segLen));
+  memset(spool->segCount, 0, sizeof(spool->segCount));
+
+  if (loadPos(spool) != QTEL_OK) {
+    spool->posSeq = 0;
+    spool->readSeg = 0;
+    spool->writeSeg = 0;
+    spool->readPos = 0;
+  }
+
+  if (spool->readSeg == spool->writeSeg) {
+    // the other segment was sent or evicted, but not deleted yet
+    getSegFilename(spool, spool->writeSeg ^ 1, filename);
+    QTEL_File_Delete(hqtel, spool->storage, filename);
+  }
+  else if (scanSegment(spool, spool->readSeg, spool->readPos) != QTEL_OK) goto openerror;
+
+  if (scanSegment(spool, spool->writeSeg,
+                  (spool->readSeg == spool->writeSeg)? spool->readPos : 0) != QTEL_OK)
+    goto openerror;
+
+  if (spool->readPos > spool->segLen[spool->readSeg])
+    spool->readPos = spool->segLen[spool->readSeg];
+  spool->count = (uint32_t) spool->segCount[0] + spool->segCount[1];
+
+  getSegFilename(spool, spool->writeSeg, filename);
+  if (QTEL_File_Open(hqtel, &spool->writeFile, spool->storage, filename) != QTEL_OK) goto openerror;
+  if (spool->writeFile.length > spool->segLen[spool->writeSeg]) {
+    if (QTEL_File_Seek(&spool->writeFile, spool->segLen[spool->writeSeg]) != QTEL_OK
+        || QTEL_File_Truncate(&spool->writeFile) != QTEL_OK)
+    {
+      QTEL_File_Close(&spool->writeFile);
+      goto openerror;
+    }
+  }
+
+  if (savePos(spool) != QTEL_OK) {
+    QTEL_File_Close(&spool->writeFile);
+    goto openerror;
+  }
+  hqtel->file.spool = spool;
+  return QTEL_OK;
+
+  openerror:
+  spool->hqtel = NULL;
+  return QTEL_ERROR;
+}
+
+
+/**
+ * record is kept after QTEL_OK is returned,
+ * QTEL_BUSY: spool is full with QTEL_SPOOL_DROP_NEWEST
+ */
+QTEL_Status_t QTEL_SPOOL_Append(QTEL_Spool_t *spool, const uint8_t *data, uint16_t length)
+{
+  QTEL_Status_t status;
+  uint8_t       header[8];
+  uint8_t       commit    = RECORD_COMMIT;
+  uint32_t      recordLen = (uint32_t) length + QTEL_SPOOL_RECORD_OVERHEAD;
+  uint32_t      crc;
+
+  if (spool->hqtel == NULL) return QTEL_ERROR;
+  if (length == 0 || recordLen > spool->bufferSize) return QTEL_ERROR;
+
+  if (spool->segLen[spool->writeSeg] + recordLen > spool->maxSize / 2) {
+    status = switchSegment(spool);
+    if (status != QTEL_OK) return status;
+  }
+
+  crc = QTEL_CRC32_Update(0, data, length);
+  header[0] = RECORD_MAGIC;
+  header[1] = 0;
+  header[2] = (uint8_t) length;
+  header[3] = (uint8_t) (length >> 8);
+  header[4] = (uint8_t) crc;
+  header[5] = (uint8_t) (crc >> 8);
+  header[6] = (uint8_t) (crc >> 16);
+  header[7] = (uint8_t) (crc >> 24);
+
+  if (spool->writeFile.pos != spool->segLen[spool->writeSeg]
+      && QTEL_File_Seek(&spool->writeFile, spool->segLen[spool->writeSeg]) != QTEL_OK)
+    return QTEL_ERROR;
+
+  // commit byte goes last, record without it is dropped at open
+  if (QTEL_File_Write(&spool->writeFile, header, sizeof(header)) != (int32_t) sizeof(header)
+      || QTEL_File_Write(&spool->writeFile, data, length) != (int32_t) length
+      || QTEL_File_Write(&spool->writeFile, &commit, 1) != 1)
+  {
+    if (QTEL_File_Seek(&spool->writeFile, spool->segLen[spool->writeSeg]) == QTEL_OK)
+      QTEL_File_Truncate(&spool->writeFile);
+    return QTEL_ERROR;
+  }
+
+  spool->segLen[spool->writeSeg] += recordLen;
+  spool->segCount[spool->writeSeg]++;
+  spool->count++;
+  return QTEL_OK;
+}
+
+
+/**
+ * send all records in batches, stops at the first failed batch
+ */
+QTEL_Status_t QTEL_SPOOL_Replay(QTEL_Spool_t *spool)
+{
+  QTEL_Status_t status = QTEL_OK;
+
+  if (spool->hqtel == NULL) return QTEL_ERROR;
+
+  while (spool->count > 0) {
+    status = replayBatch(spool);
+    if (status != QTEL_OK) break;
+  }
+  return status;
+}
+
+
+QTEL_Status_t QTEL_SPOOL_Close(QTEL_Spool_t *spool)
+{
+  QTEL_Status_t status;
+
+  if (spool->hqtel == NULL) return QTEL_ERROR;
+
+  if (spool->hqtel->file.spool == spool)
+    spool->hqtel->file.spool = NULL;
+  status = QTEL_File_Close(&spool->writeFile);
+  spool->hqtel = NULL;
+  return status;
+}
+
+
+static QTEL_Status_t loadPos(QTEL_Spool_t *spool)
+{
+  QTEL_File_t posFile;
+  SpoolPos_t  pos[2];
+  SpoolPos_t  *validPos = NULL;
+  char        filename[FILENAME_SIZE];
+  int32_t     readLen;
+  uint8_t     i;
+
+  sprintf(filename, "%s.pos", spool->name);
+  if (QTEL_File_Open(spool->hqtel, &posFile, spool->storage, filename) != QTEL_OK) return QTEL_ERROR;
+  readLen = QTEL_File_Read(&posFile, (uint8_t*) pos, sizeof(pos));
+  QTEL_File_Close(&posFile);
+
+  for (i = 0; i < 2; i++) {
+    if (readLen < (int32_t) ((i + 1) * sizeof(SpoolPos_t))
+        || pos[i].magic != QTEL_SPOOL_POS_MAGIC
+        || pos[i].crc != QTEL_CRC32_Update(0, (const uint8_t*) &pos[i], sizeof(SpoolPos_t) - 4)
+        || pos[i].readSeg > 1 || pos[i].writeSeg > 1)
+    {
+      continue;
+    }
+    if (validPos == NULL || (int16_t) (pos[i].seq - validPos->seq) > 0)
+      validPos = &pos[i];
+  }
+  if (validPos == NULL) return QTEL_ERROR;
+
+  spool->readSeg = validPos->readSeg;
+  spool->writeSeg = validPos->writeSeg;
+  spool->readPos = validPos->readPos;
+  spool->posSeq = validPos->seq;
+  return QTEL_OK;
+}
+
+
+/*
+ * slots are written in turn, an interrupted write
+ * leaves the previous position in the other slot
+ */
+static QTEL_Status_t savePos(QTEL_Spool_t *spool)
+{
+  QTEL_File_t posFile;
+  SpoolPos_t  pos;
+  char        filename[FILENAME_SIZE];
+  int32_t     writeLen;
+
+  memset(&pos, 0, sizeof(pos));
+  pos.magic = QTEL_SPOOL_POS_MAGIC;
+  pos.seq = spool->posSeq + 1;
+  pos.readSeg = spool->readSeg;
+  pos.writeSeg = spool->writeSeg;
+  pos.readPos = spool->readPos;
+  pos.crc = QTEL_CRC32_Update(0, (const uint8_t*) &pos, sizeof(pos) - 4);
+
+  sprintf(filename, "%s.pos", spool->name);
+  if (QTEL_File_Open(spool->hqtel, &posFile, spool->storage, filename) != QTEL_OK) return QTEL_ERROR;
+  if (!(pos.seq & 1) && QTEL_File_Seek(&posFile, sizeof(pos)) != QTEL_OK) {
+    QTEL_File_Close(&posFile);
+    return QTEL_ERROR;
+  }
+  writeLen = QTEL_File_Write(&posFile, (const uint8_t*) &pos, sizeof(pos));
+  QTEL_File_Close(&posFile);
+
+  if (writeLen != (int32_t) sizeof(pos)) return QTEL_ERROR;
+  spool->posSeq = pos.seq;
+  return QTEL_OK;
+}
+
+
+/*
+ * valid length and records from countFrom, the segment ends
+ * at the first record which is unfinished or corrupted
+ */
+static QTEL_Status_t scanSegment(QTEL_Spool_t *spool, uint8_t seg, uint32_t countFrom)
+{
+  QTEL_BFile_t  segFile;
+  char          filename[FILENAME_SIZE];
+  uint8_t       header[8];
+  uint8_t       tmp[32];
+  uint32_t      pos = 0;
+  uint32_t      crc;
+  uint16_t      length;
+  uint16_t      left;
+  uint16_t      readLen = 0;
+
+  getSegFilename(spool, seg, filename);
+  if (QTEL_BFile_Open(spool->hqtel, &segFile, spool->storage, filename,
+                      spool->buffer, spool->bufferSize) != QTEL_OK)
+    return QTEL_ERROR;
+
+  while (QTEL_BFile_Read(&segFile, header, sizeof(header)) == (int32_t) sizeof(header)) {
+    length = (uint16_t) (header[2] | (header[3] << 8));
+    if (header[0] != RECORD_MAGIC || length == 0
+        || (uint32_t) length + QTEL_SPOOL_RECORD_OVERHEAD > spool->bufferSize)
+      break;
+
+    crc = 0;
+    for (left = length; left > 0; left -= readLen) {
+      readLen = (left < sizeof(tmp))? left : sizeof(tmp);
+      if (QTEL_BFile_Read(&segFile, tmp, readLen) != (int32_t) readLen) break;
+      crc = QTEL_CRC32_Update(crc, tmp, readLen);
+    }
+    if (left > 0) break;
+    if (QTEL_BFile_Read(&segFile, tmp, 1) != 1 || tmp[0] != RECORD_COMMIT) break;
+    if (crc != ((uint32_t) header[4] | ((uint32_t) header[5] << 8)
+                | ((uint32_t) header[6] << 16) | ((uint32_t) header[7] << 24)))
+      break;
+
+    if (pos >= countFrom) spool->segCount[seg]++;
+    pos += (uint32_t) length + QTEL_SPOOL_RECORD_OVERHEAD;
+  }
+  QTEL_BFile_Close(&segFile);
+
+  spool->segLen[seg] = pos;
+  return QTEL_OK;
+}
+
+
+/*
+ * writing moves to the other segment, which must be sent already
+ * or is evicted by QTEL_SPOOL_DROP_OLDEST
+ */
+static QTEL_Status_t switchSegment(QTEL_Spool_t *spool)
+{
+  char    filename[FILENAME_SIZE];
+  uint8_t otherSeg = spool->writeSeg ^ 1;
+
+  if (spool->readSeg == otherSeg) {
+    if (spool->segCount[otherSeg] > 0) {
+      if (spool->policy == QTEL_SPOOL_DROP_NEWEST) return QTEL_BUSY;
+      spool->dropped += spool->segCount[otherSeg];
+      spool->count -= spool->segCount[otherSeg];
+      spool->segCount[otherSeg] = 0;
+    }
+
+    // saved before the delete, so the segment is never read after it
+    spool->readSeg = spool->writeSeg;
+    spool->readPos = 0;
+    if (savePos(spool) != QTEL_OK) return QTEL_ERROR;
+  }
+
+  QTEL_File_Close(&spool->writeFile);
+  getSegFilename(spool, otherSeg, filename);
+  QTEL_File_Delete(spool->hqtel, spool->storage, filename);
+  spool->segLen[otherSeg] = 0;
+
+  // segment which isn't saved as the write one is deleted as old one at open,
+  // so nothing is written into it before the position is saved
+  spool->writeSeg = otherSeg;
+  if (savePos(spool) != QTEL_OK) {
+    spool->writeSeg ^= 1;
+    getSegFilename(spool, spool->writeSeg, filename);
+    QTEL_File_Open(spool->hqtel, &spool->writeFile, spool->storage, filename);
+    return QTEL_ERROR;
+  }
+
+  if (QTEL_File_Open(spool->hqtel, &spool->writeFile, spool->storage, filename) != QTEL_OK)
+    return QTEL_ERROR;
+  return QTEL_OK;
+}
+
+
+/*
+ * read segment is fully sent, older segment is deleted
+ * and the last one is cut to zero
+ */
+static QTEL_Status_t finishSegment(QTEL_Spool_t *spool)
+{
+  char      filename[FILENAME_SIZE];
+  uint8_t   seg = spool->readSeg;
+  uint32_t  readPos;
+
+  if (seg != spool->writeSeg) {
+    spool->readSeg = spool->writeSeg;
+    spool->readPos = 0;
+    if (savePos(spool) != QTEL_OK) return QTEL_ERROR;
+
+    getSegFilename(spool, seg, filename);
+    QTEL_File_Delete(spool->hqtel, spool->storage, filename);
+    spool->segLen[seg] = 0;
+    spool->segCount[seg] = 0;
+    return QTEL_OK;
+  }
+
+  // saved before the cut, so records appended after it are never skipped,
+  // interrupted cut only sends the old records again
+  readPos = spool->readPos;
+  spool->readPos = 0;
+  if (savePos(spool) != QTEL_OK) {
+    spool->readPos = readPos;
+    return QTEL_ERROR;
+  }
+  if (QTEL_File_Seek(&spool->writeFile, 0) != QTEL_OK
+      || QTEL_File_Truncate(&spool->writeFile) != QTEL_OK)
+    return QTEL_ERROR;
+  spool->segLen[seg] = 0;
+  return QTEL_OK;
+}
+
+
+/*
+ * whole records which fit in buffer are read at once,
+ * they are packed in place with their length and passed to onSend
+ */
+static QTEL_Status_t replayBatch(QTEL_Spool_t *spool)
+{
+  QTEL_File_t   readFile;
+  QTEL_File_t   *file       = &spool->writeFile;
+  uint8_t       *buffer     = spool->buffer;
+  char          filename[FILENAME_SIZE];
+  uint32_t      readLen;
+  int32_t       fileReadLen = -1;
+  uint16_t      offset      = 0;
+  uint16_t      dataLen     = 0;
+  uint16_t      recordLen;
+  uint16_t      count       = 0;
+  uint8_t       seg;
+
+  if (spool->count == 0) return QTEL_OK;
+  if (spool->readPos >= spool->segLen[spool->readSeg]) {
+    if (finishSegment(spool) != QTEL_OK) return QTEL_ERROR;
+    if (spool->readPos >= spool->segLen[spool->readSeg]) {
+      spool->count = 0;
+      return QTEL_OK;
+    }
+  }
+  seg = spool->readSeg;
+
+  if (seg != spool->writeSeg) {
+    getSegFilename(spool, seg, filename);
+    if (QTEL_File_Open(spool->hqtel, &readFile, spool->storage, filename) != QTEL_OK)
+      return QTEL_ERROR;
+    file = &readFile;
+  }
+
+  readLen = spool->segLen[seg] - spool->readPos;
+  if (readLen > spool->bufferSize) readLen = spool->bufferSize;
+  if (file->pos == spool->readPos || QTEL_File_Seek(file, spool->readPos) == QTEL_OK)
+    fileReadLen = QTEL_File_Read(file, buffer, (uint16_t) readLen);
+  if (file == &readFile) QTEL_File_Close(&readFile);
+  if (fileReadLen <= 0) return QTEL_ERROR;
+
+  while (offset + QTEL_SPOOL_RECORD_OVERHEAD <= fileReadLen) {
+    recordLen = (uint16_t) (buffer[offset+2] | (buffer[offset+3] << 8));
+    if (buffer[offset] != RECORD_MAGIC
+        || offset + recordLen + QTEL_SPOOL_RECORD_OVERHEAD > fileReadLen)
+      break;
+    buffer[dataLen]   = buffer[offset+2];
+    buffer[dataLen+1] = buffer[offset+3];
+    memmove(&buffer[dataLen+2], &buffer[offset+8], recordLen);
+    dataLen += recordLen + 2;
+    offset += recordLen + QTEL_SPOOL_RECORD_OVERHEAD;
+    count++;
+  }
+
+  if (count == 0) {
+    recordLen = (uint16_t) (buffer[2] | (buffer[3] << 8));
+    if (buffer[0] == RECORD_MAGIC
+        && (uint32_t) recordLen + QTEL_SPOOL_RECORD_OVERHEAD <= readLen)
+      return QTEL_ERROR;
+
+    // changed in storage after it was checked, rest of the segment is lost
+    QTEL_Debug("[Spool] corrupted record at %lu", (unsigned long) spool->readPos);
+    spool->dropped += spool->segCount[seg];
+    spool->count -= spool->segCount[seg];
+    spool->segCount[seg] = 0;
+    spool->readPos = spool->segLen[seg];
+    return finishSegment(spool);
+  }
+
+  if (spool->onSend == NULL || spool->onSend(spool->ctx, buffer, dataLen, count) != QTEL_OK)
+    return QTEL_ERROR;
+
+  spool->readPos += offset;
+  spool->segCount[seg] -= count;
+  spool->count -= count;
+  if (spool->readPos >= spool->segLen[seg]) return finishSegment(spool);
+  return savePos(spool);
+}
+
+
+static void getSegFilename(QTEL_Spool_t *spool, uint8_t seg, char *filename)
+{
+  sprintf(filename, "%s.%u", spool->name, (unsigned int) seg);
+}
+
+#endif /* QTEL_EN_FEATURE_SPOOL */
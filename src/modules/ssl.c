@@ -0,0 +1,190 @@
+/*
+ * ssl.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/net.h"
+#include "../include/quectel/ssl.h"
+#include "../include/quectel/file.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_SSL
+
+static char* keyStr[QTEL_SSL_CFG_KEYS_NUM] = {
+  "sslversion",
+  "ciphersuite",
+  "cacert",
+  "clientcert",
+  "clientkey",
+  "seclevel",
+  "ignorelocaltime",
+  "negotiatetime",
+  "sni",
+  "session_cache",
+};
+
+static QTEL_Status_t applyContext(QTEL_HandlerTypeDef*, const QTEL_SSL_Context_t*);
+static uint8_t       isIgnoreLocalTime(QTEL_HandlerTypeDef*, const QTEL_SSL_Context_t*);
+
+
+/*
+ * SSL configuration is not kept by the modem after restart,
+ * reapply the registered contexts when data is online again
+ */
+void QTEL_SSL_OnNetOpened(QTEL_HandlerTypeDef *hqtel)
+{
+  for (uint8_t i = 0; i < QTEL_SSL_NUM_OF_CONTEXT; i++) {
+    if (hqtel->net.sslContexts[i] != NULL) {
+      applyContext(hqtel, (const QTEL_SSL_Context_t*) hqtel->net.sslContexts[i]);
+    }
+  }
+}
+
+
+/*
+ * certificates of QTEL_SSL_LOCALTIME_AUTO contexts are checked
+ * against local time from now
+ */
+void QTEL_SSL_OnClockSynced(QTEL_HandlerTypeDef *hqtel)
+{
+  const QTEL_SSL_Context_t  *ctx;
+  uint8_t                   ignoreLocalTm = 0;
+
+  for (uint8_t i = 0; i < QTEL_SSL_NUM_OF_CONTEXT; i++) {
+    ctx = (const QTEL_SSL_Context_t*) hqtel->net.sslContexts[i];
+    if (ctx != NULL && ctx->localTime == QTEL_SSL_LOCALTIME_AUTO)
+      QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_IgnoreLocalTime, &ignoreLocalTm);
+  }
+}
+
+
+QTEL_Status_t QTEL_SSL_Config(QTEL_HandlerTypeDef *hqtel, uint8_t ctxId, QTEL_SSL_ConfigKey_t key, void *value)
+{
+  QTEL_Status_t status = QTEL_ERROR;
+
+  QTEL_LOCK(hqtel);
+
+  switch (key) {
+  case QTEL_SSL_CFG_CipherSuite:
+    QTEL_SendCMD(hqtel, "AT+QSSLCFG=\"%s\",%u,0X%04X", keyStr[key], ctxId, *(uint16_t*)value);
+    break;
+  case QTEL_SSL_CFG_CACert:
+  case QTEL_SSL_CFG_ClientCert:
+  case QTEL_SSL_CFG_ClientKey:
+    QTEL_SendCMD(hqtel, "AT+QSSLCFG=\"%s\",%u,\"UFS:%s\"", keyStr[key], ctxId, (char*)value);
+    break;
+  case QTEL_SSL_CFG_NegotiateTime:
+    QTEL_SendCMD(hqtel, "AT+QSSLCFG=\"%s\",%u,%u", keyStr[key], ctxId, *(uint16_t*)value);
+    break;
+  default:
+    QTEL_SendCMD(hqtel, "AT+QSSLCFG=\"%s\",%u,%u", keyStr[key], ctxId, *(uint8_t*)value);
+    break;
+  }
+
+  if (!QTEL_IsResponseOK(hqtel)) goto endcmd;
+  status = QTEL_OK;
+
+  endcmd:
+  QTEL_UNLOCK(hqtel);
+  return status;
+}
+
+
+/*
+ * configure SSL context and keep it to be reapplied after modem restart,
+ * ctx must stay valid while it is used
+ */
+QTEL_Status_t QTEL_SSL_SetupContext(QTEL_HandlerTypeDef *hqtel, const QTEL_SSL_Context_t *ctx)
+{
+  if (ctx->ctxId >= QTEL_SSL_NUM_OF_CONTEXT) return QTEL_ERROR;
+
+  hqtel->net.sslContexts[ctx->ctxId] = (const void*) ctx;
+  return applyContext(hqtel, ctx);
+}
+
+
+/*
+ * store certificate or key into UFS, replace the existing file
+ */
+QTEL_Status_t QTEL_SSL_UploadFile(QTEL_HandlerTypeDef *hqtel, const char *filename,
+                                  uint8_t *data, uint16_t dataLen)
+{
+  QTEL_File_Delete(hqtel, QTEL_File_Storage_UFS, filename);
+  return QTEL_File_Upload(hqtel, QTEL_File_Storage_UFS, filename, data, dataLen);
+}
+
+
+static QTEL_Status_t applyContext(QTEL_HandlerTypeDef *hqtel, const QTEL_SSL_Context_t *ctx)
+{
+  QTEL_Status_t status;
+  uint8_t       sslVersion    = ctx->sslVersion;
+  uint8_t       secLevel      = ctx->secLevel;
+  uint8_t       sni           = ctx->sni;
+  uint8_t       sessionCache  = ctx->sessionCache;
+  uint8_t       ignoreLocalTm = isIgnoreLocalTime(hqtel, ctx);
+  uint16_t      cipherSuite   = (ctx->cipherSuite == 0)? 0xFFFF : ctx->cipherSuite;
+  uint16_t      negotiateTime = (ctx->negotiateTime == 0)? 300 : ctx->negotiateTime;
+
+  status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_SSLVersion, &sslVersion);
+  if (status != QTEL_OK) goto endcmd;
+
+  status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_CipherSuite, &cipherSuite);
+  if (status != QTEL_OK) goto endcmd;
+
+  status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_SecLevel, &secLevel);
+  if (status != QTEL_OK) goto endcmd;
+
+  status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_IgnoreLocalTime, &ignoreLocalTm);
+  if (status != QTEL_OK) goto endcmd;
+
+  status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_NegotiateTime, &negotiateTime);
+  if (status != QTEL_OK) goto endcmd;
+
+  status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_SNI, &sni);
+  if (status != QTEL_OK) goto endcmd;
+
+  if (ctx->caCertFile != NULL) {
+    status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_CACert, (void*) ctx->caCertFile);
+    if (status != QTEL_OK) goto endcmd;
+  }
+
+  if (ctx->clientCertFile != NULL) {
+    status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_ClientCert, (void*) ctx->clientCertFile);
+    if (status != QTEL_OK) goto endcmd;
+  }
+
+  if (ctx->clientKeyFile != NULL) {
+    status = QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_ClientKey, (void*) ctx->clientKeyFile);
+    if (status != QTEL_OK) goto endcmd;
+  }
+
+  // not all firmware support session cache, don't fail the context for it
+  if (QTEL_SSL_Config(hqtel, ctx->ctxId, QTEL_SSL_CFG_SessionCache, &sessionCache) != QTEL_OK) {
+    QTEL_Debug("[SSL] session cache is not supported");
+  }
+
+  endcmd:
+  return status;
+}
+
+
+static uint8_t isIgnoreLocalTime(QTEL_HandlerTypeDef *hqtel, const QTEL_SSL_Context_t *ctx)
+{
+  if (ctx->localTime == QTEL_SSL_LOCALTIME_IGNORE) return 1;
+  if (ctx->localTime == QTEL_SSL_LOCALTIME_CHECK)  return 0;
+
+  // time of the modem before sync can be far from the real one
+#if QTEL_EN_FEATURE_NTP
+  return !QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_NTP_WAS_SYNCED);
+#else
+  return 1;
+#endif
+}
+
+#endif /* QTEL_EN_FEATURE_SSL */
@@ -0,0 +1,286 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: janoko
+ */
+
+#include "../include/quectel.h"
+#include "../include/quectel/http.h"
+#include "../include/quectel/file.h"
+#include "../include/quectel/deflate.h"
+#include "../include/quectel/telemetry.h"
+#include "../include/quectel/utils.h"
+#include "../include/quectel/debug.h"
+#include <stdio.h>
+#include <string.h>
+
+#if QTEL_EN_FEATURE_HTTP && QTEL_EN_FEATURE_TELEMETRY
+
+static QTEL_Status_t  openBatch(QTEL_Telemetry_t*);
+static void           closeBatch(QTEL_Telemetry_t*, uint8_t isSent);
+static QTEL_Status_t  uploadBatch(QTEL_Telemetry_t*);
+static QTEL_Status_t  sendBatch(QTEL_Telemetry_t*);
+static void           writeBatch(void *ctx, const uint8_t *data, uint16_t length);
+static uint32_t       getBound(QTEL_Telemetry_t*, uint16_t length);
+static uint32_t       getLimit(QTEL_Telemetry_t*);
+static uint8_t        isCompressed(QTEL_Telemetry_t*);
+
+
+void QTEL_TELEMETRY_HandleEvents(QTEL_HandlerTypeDef *hqtel)
+{
+  QTEL_Telemetry_t *tlm = (QTEL_Telemetry_t*) hqtel->HTTP.telemetry;
+
+  if (tlm == NULL || !QTEL_NET_IS_STATUS(hqtel, QTEL_NET_STATUS_OPEN)) return;
+
+  // blocking request can't be sent while the queue is running
+  if (tlm->onSend == NULL && QTEL_HTTP_GetActive(hqtel) != NULL) return;
+
+  if (tlm->isSealed) {
+    if (QTEL_IsTimeout(tlm->tick, tlm->retryInterval))
+      uploadBatch(tlm);
+  }
+  else if (tlm->isOpen && tlm->records > 0 && tlm->interval != 0
+           && QTEL_IsTimeout(tlm->tick, tlm->interval))
+  {
+    uploadBatch(tlm);
+  }
+}
+
+
+/**
+ * batch is uploaded in background while network is open
+ */
+QTEL_Status_t QTEL_TELEMETRY_Init(QTEL_HandlerTypeDef *hqtel, QTEL_Telemetry_t *tlm)
+{
+  if (tlm->url == NULL && tlm->onSend == NULL) return QTEL_ERROR;
+  if (tlm->buffer == NULL || tlm->bufferSize == 0) return QTEL_ERROR;
+
+  // sender gets the batch from buffer
+  if (tlm->filename != NULL && (tlm->onSend != NULL || tlm->batchSize == 0)) return QTEL_ERROR;
+
+  tlm->hqtel = hqtel;
+  tlm->isOpen = 0;
+  tlm->isSealed = 0;
+  tlm->isError = 0;
+  memset(&tlm->stats, 0, sizeof(QTEL_Telemetry_Stats_t));
+  hqtel->HTTP.telemetry = tlm;
+  return QTEL_OK;
+}
+
+
+/**
+ * QTEL_BUSY: previous batch is waiting for retry,
+ * full batch is uploaded before the record is added
+ */
+QTEL_Status_t QTEL_TELEMETRY_Add(QTEL_Telemetry_t *tlm, const uint8_t *data, uint16_t length)
+{
+  if (tlm->hqtel == NULL) return QTEL_ERROR;
+  if (length == 0) return QTEL_OK;
+  if (tlm->isSealed) return QTEL_BUSY;
+
+  if (tlm->isOpen && tlm->records > 0 && getBound(tlm, length) > getLimit(tlm)) {
+    if (uploadBatch(tlm) != QTEL_OK && tlm->isSealed) return QTEL_BUSY;
+  }
+
+  if (!tlm->isOpen && openBatch(tlm) != QTEL_OK) return QTEL_ERROR;
+  if (getBound(tlm, length) > getLimit(tlm)) return QTEL_ERROR;
+
+  #if QTEL_EN_FEATURE_DEFLATE
+  if (tlm->deflater != NULL) QTEL_Deflate_Write(tlm->deflater, data, length);
+  else
+  #endif
+  writeBatch(tlm, data, length);
+
+  tlm->rawLength += length;
+  tlm->records++;
+
+  if (tlm->isError) {
+    QTEL_Debug("[Telemetry] batch %lu can't be written", (unsigned long) tlm->batchId);
+    tlm->stats.dropped += tlm->records;
+    closeBatch(tlm, 0);
+    return QTEL_ERROR;
+  }
+  return QTEL_OK;
+}
+
+
+/**
+ * upload the collected records now
+ */
+QTEL_Status_t QTEL_TELEMETRY_Flush(QTEL_Telemetry_t *tlm)
+{
+  if (tlm->hqtel == NULL) return QTEL_ERROR;
+  if (!tlm->isSealed && (!tlm->isOpen || tlm->records == 0)) return QTEL_OK;
+  return uploadBatch(tlm);
+}
+
+
+void QTEL_TELEMETRY_GetStats(QTEL_Telemetry_t *tlm, QTEL_Telemetry_Stats_t *stats)
+{
+  memcpy(stats, &tlm->stats, sizeof(QTEL_Telemetry_Stats_t));
+  stats->savedBytes = (stats->rawBytes > stats->sentBytes)? (stats->rawBytes - stats->sentBytes) : 0;
+  stats->ratio = (stats->rawBytes == 0)? 100
+                 : (uint16_t) ((uint64_t) stats->sentBytes * 100 / stats->rawBytes);
+}
+
+
+static QTEL_Status_t openBatch(QTEL_Telemetry_t *tlm)
+{
+  if (tlm->filename != NULL) {
+    QTEL_File_Delete(tlm->hqtel, QTEL_File_Storage_UFS, tlm->filename);
+    if (QTEL_BFile_Open(tlm->hqtel, &tlm->file, QTEL_File_Storage_UFS, tlm->filename,
+                        tlm->buffer, tlm->bufferSize) != QTEL_OK)
+      return QTEL_ERROR;
+  }
+
+  tlm->isOpen = 1;
+  tlm->isError = 0;
+  tlm->retry = 0;
+  tlm->length = 0;
+  tlm->rawLength = 0;
+  tlm->records = 0;
+  tlm->tick = QTEL_GetTick();
+
+  #if QTEL_EN_FEATURE_DEFLATE
+  if (tlm->deflater != NULL)
+    QTEL_Deflate_Begin(tlm->deflater, QTEL_DEFLATE_FORMAT_GZIP, writeBatch, tlm);
+  #endif
+  return QTEL_OK;
+}
+
+
+static void closeBatch(QTEL_Telemetry_t *tlm, uint8_t isSent)
+{
+  if (tlm->filename != NULL && !tlm->isSealed) QTEL_BFile_Close(&tlm->file);
+
+  // id of batch given up isn't reused, the server may have got it
+  tlm->batchId++;
+  tlm->isOpen = 0;
+  tlm->isSealed = 0;
+  if (!isSent) return;
+
+  tlm->stats.batches++;
+  tlm->stats.records += tlm->records;
+  tlm->stats.rawBytes += tlm->rawLength;
+  tlm->stats.sentBytes += tlm->length;
+}
+
+
+static QTEL_Status_t uploadBatch(QTEL_Telemetry_t *tlm)
+{
+  QTEL_Status_t status;
+
+  if (!tlm->isSealed) {
+    #if QTEL_EN_FEATURE_DEFLATE
+    if (tlm->deflater != NULL) QTEL_Deflate_Finish(tlm->deflater);
+    #endif
+    if (tlm->filename != NULL && QTEL_BFile_Close(&tlm->file) != QTEL_OK)
+      tlm->isError = 1;
+    tlm->isSealed = 1;
+  }
+
+  if (tlm->isError) {
+    tlm->stats.dropped += tlm->records;
+    closeBatch(tlm, 0);
+    return QTEL_ERROR;
+  }
+
+  status = sendBatch(tlm);
+  if (status == QTEL_OK) {
+    closeBatch(tlm, 1);
+    return QTEL_OK;
+  }
+
+  tlm->retry++;
+  tlm->tick = QTEL_GetTick();
+  if (tlm->maxRetry != 0 && tlm->retry >= tlm->maxRetry) {
+    QTEL_Debug("[Telemetry] batch %lu is dropped", (unsigned long) tlm->batchId);
+    tlm->stats.dropped += tlm->records;
+    closeBatch(tlm, 0);
+  }
+  return status;
+}
+
+
+static QTEL_Status_t sendBatch(QTEL_Telemetry_t *tlm)
+{
+  QTEL_Status_t       status;
+  QTEL_HTTP_Request_t req;
+  char                url[QTEL_TELEMETRY_URL_SIZE];
+
+  if (tlm->onSend != NULL)
+    return tlm->onSend(tlm->ctx, tlm->batchId, tlm->buffer, (uint16_t) tlm->length);
+
+  if (snprintf(url, sizeof(url), "%s%cbatch=%08lX",
+               tlm->url, (strchr(tlm->url, '?') != NULL)? '&' : '?',
+               (unsigned long) tlm->batchId) >= (int) sizeof(url))
+  {
+    return QTEL_ERROR;
+  }
+
+  memset(&req, 0, sizeof(QTEL_HTTP_Request_t));
+  req.method = QTEL_HTTP_POST;
+  req.url = url;
+  req.timeout = tlm->timeout;
+  req.customHeader = isCompressed(tlm)? "Content-Encoding: gzip" : NULL;
+  req.body.contentType = tlm->contentType;
+  if (tlm->filename != NULL) {
+    req.body.filename = tlm->filename;
+  }
+  else {
+    req.body.data = tlm->buffer;
+    req.body.length = tlm->length;
+  }
+
+  status = QTEL_HTTP_Send(tlm->hqtel, &req);
+  if (status != QTEL_OK) return status;
+  if (tlm->hqtel->HTTP.response.code < 200 || tlm->hqtel->HTTP.response.code >= 300)
+    return QTEL_ERROR;
+  return QTEL_OK;
+}
+
+
+static void writeBatch(void *ctx, const uint8_t *data, uint16_t length)
+{
+  QTEL_Telemetry_t *tlm = (QTEL_Telemetry_t*) ctx;
+
+  if (tlm->filename != NULL) {
+    if (QTEL_BFile_Write(&tlm->file, data, length) != (int32_t) length)
+      tlm->isError = 1;
+  }
+  else memcpy(&tlm->buffer[tlm->length], data, length);
+  tlm->length += length;
+}
+
+
+/*
+ * batch length after the record is added and the batch is finished
+ */
+static uint32_t getBound(QTEL_Telemetry_t *tlm, uint16_t length)
+{
+  #if QTEL_EN_FEATURE_DEFLATE
+  if (tlm->deflater != NULL) return tlm->length + QTEL_Deflate_GetBound(tlm->deflater, length);
+  #endif
+  return tlm->length + length;
+}
+
+
+static uint32_t getLimit(QTEL_Telemetry_t *tlm)
+{
+  if (tlm->filename == NULL && (tlm->batchSize == 0 || tlm->batchSize > tlm->bufferSize))
+    return tlm->bufferSize;
+  return tlm->batchSize;
+}
+
+
+static uint8_t isCompressed(QTEL_Telemetry_t *tlm)
+{
+  #if QTEL_EN_FEATURE_DEFLATE
+  return (tlm->deflater != NULL);
+  #else
+  return 0;
+  #endif
+}
+
+#endif /* QTEL_EN_FEATURE_HTTP && QTEL_EN_FEATURE_TELEMETRY */
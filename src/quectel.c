@@ -12,8 +12,12 @@
 #include "include/quectel/debug.h"
 #include "include/quectel/net.h"
 #include "include/quectel/socket.h"
+#include "include/quectel/dns.h"
+#include "include/quectel/ping.h"
 #include "include/quectel/http.h"
 #include "include/quectel/gps.h"
+#include "include/quectel/spool.h"
+#include "include/quectel/telemetry.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -95,6 +99,14 @@ void QTEL_CheckAsyncResponse(QTEL_HandlerTypeDef *hqtel)
   else if (QTEL_NET_CheckAsyncResponse(hqtel)) return;
   #endif
 
+  #if QTEL_EN_FEATURE_DNS
+  else if (QTEL_DNS_CheckAsyncResponse(hqtel)) return;
+  #endif
+
+  #if QTEL_EN_FEATURE_PING
+  else if (QTEL_PING_CheckAsyncResponse(hqtel)) return;
+  #endif
+
   #if QTEL_EN_FEATURE_SOCKET
   else if (QTEL_SockCheckAsyncResponse(hqtel)) return;
   #endif
@@ -149,6 +161,12 @@ void QTEL_HandleEvents(QTEL_HandlerTypeDef *hqtel)
     QTEL_Debug("Started.");
     QTEL_AutoUpdateTZ(hqtel, 1);
     QTEL_SockOnStarted(hqtel);
+    #if QTEL_EN_FEATURE_HTTP
+    QTEL_HTTP_OnStarted(hqtel);
+    #endif
+    #if QTEL_EN_FEATURE_SPOOL
+    QTEL_SPOOL_OnStarted(hqtel);
+    #endif
   }
   if (QTEL_BITS_IS(hqtel->events, QTEL_EVENT_ON_REGISTERED)) {
     QTEL_BITS_UNSET(hqtel->events, QTEL_EVENT_ON_REGISTERED);
@@ -159,18 +177,34 @@ void QTEL_HandleEvents(QTEL_HandlerTypeDef *hqtel)
   QTEL_NET_HandleEvents(hqtel);
 #endif
 
+#if QTEL_EN_FEATURE_DNS
+  QTEL_DNS_HandleEvents(hqtel);
+#endif
+
 #ifdef QTEL_EN_FEATURE_SOCKET
   QTEL_SockHandleEvents(hqtel);
 #endif
 
+#if QTEL_EN_FEATURE_PING
+  QTEL_PING_HandleEvents(hqtel);
+#endif
+
 #ifdef QTEL_EN_FEATURE_HTTP
   QTEL_HTTP_HandleEvents(hqtel);
 #endif
 
+#if QTEL_EN_FEATURE_TELEMETRY
+  QTEL_TELEMETRY_HandleEvents(hqtel);
+#endif
+
 #if QTEL_EN_FEATURE_GPS
   QTEL_GPS_HandleEvents(hqtel);
 #endif
 
+#if QTEL_EN_FEATURE_SPOOL
+  QTEL_SPOOL_HandleEvents(hqtel);
+#endif
+
 }
 
 
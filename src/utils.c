@@ -262,3 +262,21 @@ const uint8_t * QTEL_ParseStr(const uint8_t *separator, uint8_t delimiter, int i
 
   return separator;
 }
+
+
+/*
+ * pseudo random number, override it with hardware RNG
+ * or seed from unique ID to keep devices out of lockstep
+ */
+__attribute__((weak)) uint32_t QTEL_Random(void)
+{
+  static uint32_t state = 0;
+
+  if (state == 0) state = QTEL_GetTick() ^ (uint32_t) (uintptr_t) &state ^ 0x9E3779B9;
+
+  // xorshift32
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}